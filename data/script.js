@@ -2,6 +2,10 @@
 const intervals = [1,5,10,15,20,30,60];
 let currentWeek = null;
 let chart = null;
+let schema = null; // record layout from /api/schema (CSV columns after ts)
+const channelColors = ['red', 'blue', 'green', 'orange'];
+// CSV of the shown week; refreshes only fetch the bytes appended since (HTTP Range)
+let weekCache = { week: null, etag: null, csv: '' };
 
 function humanBytes(b) {
   if (b < 1024) return b + ' B';
@@ -14,6 +18,10 @@ async function fetchJSON(path) {
   return await r.json();
 }
 
+async function loadSchema() {
+  schema = await fetchJSON('/api/schema');
+}
+
 async function refreshStorage() {
   const info = await fetchJSON('/api/storageinfo');
   document.getElementById('storage').innerText = `Speicher: ${humanBytes(info.used_bytes)} von ${humanBytes(info.total_bytes)} (~${info.percent}%)`;
@@ -58,76 +66,86 @@ async function listWeeks() {
 
 async function loadWeek(week) {
   currentWeek = week;
-  const url = `/api/download_week?week=${encodeURIComponent(week)}`;
-  const r = await fetch(url);
-  if (!r.ok) { alert('Fehler beim Laden'); return; }
-  const csv = await r.text();
+  const csv = await fetchWeekCSV(week);
+  if (csv === null) { alert('Fehler beim Laden'); return; }
   const lines = csv.trim().split('\n');
   const labels = [];
-  const temps = [];
-  const hums = [];
+  const series = schema.channels.map(() => []);
   for (let i=0;i<lines.length;i++) {
-    const parts = lines[i].split(';');
-    if (parts.length<3) continue;
+    const parts = lines[i].split(schema.separator);
+    if (parts.length<1+schema.channels.length) continue;
     const ts = parseInt(parts[0])*1000;
     labels.push(new Date(ts).toLocaleString());
-    temps.push(parseFloat(parts[1]));
-    hums.push(parseFloat(parts[2]));
+    series.forEach((values, c) => values.push(parseFloat(parts[1+c])));
   }
-  drawChart(labels, temps, hums);
+  drawChart(labels, series);
   // Update last measured value
   await displayLatestMeasurement();
 }
 
-function drawChart(labels, temps, hums) {
+// Week CSV, for the cached week only the new tail (206), or nothing new (416).
+// If-Range makes the device send the whole file again if the week was recreated
+async function fetchWeekCSV(week) {
+  const url = `/api/download_week?week=${encodeURIComponent(week)}`;
+  const cached = weekCache.week === week && weekCache.etag;
+  const headers = cached ? { 'Range': `bytes=${weekCache.csv.length}-`, 'If-Range': weekCache.etag } : {};
+  const r = await fetch(url, { headers: headers, cache: 'no-store' });
+
+  if (r.status === 416 && cached) return weekCache.csv;
+  if (!r.ok) return null;
+  const text = await r.text();
+  if (r.status === 206) {
+    weekCache.csv += text;
+  } else {
+    weekCache = { week: week, etag: null, csv: text };
+  }
+  // a gzip answer carries the gzip ETag; the cache holds the decoded (identity) bytes
+  weekCache.etag = r.headers.get('X-Identity-ETag') || r.headers.get('ETag');
+  return weekCache.csv;
+}
+
+function drawChart(labels, series) {
     const ctx = document.getElementById('chart').getContext('2d');
 
     // vorhandenen Chart zerstören
     if (chart) chart.destroy();
 
+    // one dataset and y axis per channel, axes alternate left/right
+    const datasets = [];
+    const scales = {
+        x: {
+            display: true,
+            title: { display: true, text: 'Zeit' }
+        }
+    };
+    schema.channels.forEach((c, i) => {
+        const axis = 'y' + c.name;
+        datasets.push({
+            label: `${c.label} (${c.unit})`,
+            data: series[i],
+            borderColor: channelColors[i % channelColors.length],
+            fill: false,
+            yAxisID: axis
+        });
+        scales[axis] = {
+            type: 'linear',
+            display: true,
+            position: i % 2 ? 'right' : 'left',
+            title: { display: true, text: c.unit },
+            grid: { drawOnChartArea: i === 0 } // damit Linien sich nicht überlagern
+        };
+    });
+
     chart = new Chart(ctx, {
         type: 'line',
         data: {
             labels: labels,
-            datasets: [
-                {
-                    label: 'Temperature (°C)',
-                    data: temps,
-                    borderColor: 'red',
-                    fill: false,
-                    yAxisID: 'yTemp'
-                },
-                {
-                    label: 'Humidity (%)',
-                    data: hums,
-                    borderColor: 'blue',
-                    fill: false,
-                    yAxisID: 'yHum'
-                }
-            ]
+            datasets: datasets
         },
         options: {
             responsive: true,
             maintainAspectRatio: false, // damit div height genutzt wird
-            scales: {
-                x: {
-                    display: true,
-                    title: { display: true, text: 'Zeit' }
-                },
-                yTemp: {
-                    type: 'linear',
-                    display: true,
-                    position: 'left',
-                    title: { display: true, text: '°C' }
-                },
-                yHum: {
-                    type: 'linear',
-                    display: true,
-                    position: 'right',
-                    title: { display: true, text: '%' },
-                    grid: { drawOnChartArea: false } // damit Linien sich nicht überlagern
-                }
-            }
+            scales: scales
         }
     });
 }
@@ -211,6 +229,33 @@ async function deletePrev() {
   await listWeeks();
 }
 
+// Upload a week CSV or the "alle Wochen" ZIP back onto the device
+async function importBackup() {
+  const input = document.getElementById('importFile');
+  if (!input.files.length) { alert('Bitte zuerst eine CSV- oder ZIP-Datei wählen'); return; }
+  const pw = prompt('Geben Sie das Admin-Passwort ein:');
+  if (!pw) return;
+
+  const form = new FormData();
+  form.append('file', input.files[0]);
+  const response = await fetch('/api/import', {
+    method: 'POST',
+    headers: { 'Authorization': pw },
+    body: form
+  });
+
+  if (!response.ok) {
+    const errorText = await response.text();
+    alert(`Import fehlgeschlagen: ${errorText}`);
+    return;
+  }
+  const js = await response.json();
+  alert(`${js.records} Messwerte importiert (${js.rejected} ungültig, ${js.skipped} schon vorhanden oder nicht in zeitlicher Reihenfolge), ${humanBytes(js.bytes)} mit ${js.kbps.toFixed(1)} KB/s`);
+
+  await refreshStorage();
+  await listWeeks();
+}
+
 // Update the UI based on measurement status
 function updateMeasurementUI(isOn) {
   const btn = document.getElementById('btnToggleMeasurement');
@@ -237,6 +282,7 @@ async function refreshMeasurementState() {
   const js = await r.json();
 
   updateMeasurementUI(js.measurementActive);
+  showWifiState(js.wifi);
 
   // Intervall im Dropdown setzen
   document.getElementById('intervalSelect').value = js.interval;
@@ -244,6 +290,21 @@ async function refreshMeasurementState() {
   return js.measurementActive;
 }
 
+// WiFi state incl. the result of the last credentials change (see /api/status)
+function showWifiState(wifi) {
+  if (!wifi) return;
+  const changes = {
+    connecting: 'verbinde mit neuen Zugangsdaten …',
+    ok: 'neue Zugangsdaten aktiv',
+    reverted: 'neue Zugangsdaten fehlgeschlagen, vorherige wiederhergestellt',
+    failed: 'neue Zugangsdaten fehlgeschlagen'
+  };
+  let text = `WLAN: ${wifi.ssid} (${wifi.connected ? 'verbunden' : 'nicht verbunden'})`;
+  if (wifi.config_ap) text += ' – Konfigurations-AP aktiv';
+  if (changes[wifi.change]) text += ` – ${changes[wifi.change]}`;
+  document.getElementById('wifi').innerText = text;
+}
+
 // Toggle measurement on/off on server and update UI
 async function toggleMeasurement() {
   const r = await fetch('/api/toggleMeasurement', { method: 'POST' });
@@ -289,7 +350,8 @@ async function displayLatestMeasurement() {
     const js = await r.json();
     const span = document.getElementById('live');
     const timeStr = new Date(js.ts * 1000).toLocaleTimeString();
-    span.innerText = `${js.temp.toFixed(1)} °C, ${js.hum.toFixed(1)} % (${timeStr})`;
+    const values = schema.channels.map(c => `${js[c.name].toFixed(c.decimals)} ${c.unit}`);
+    span.innerText = `${values.join(', ')} (${timeStr})`;
   } catch (e) {
     console.error('Failed to fetch latest measurement', e);
   }
@@ -297,6 +359,7 @@ async function displayLatestMeasurement() {
 
 
 document.addEventListener('DOMContentLoaded', async () => {
+  await loadSchema();
   await refreshStorage();
   await listWeeks();
   await refreshMeasurementState();
@@ -308,6 +371,12 @@ document.addEventListener('DOMContentLoaded', async () => {
   document.getElementById('btnFlushBuffer').addEventListener('click', flushNow);
   document.getElementById('btnDeletePrev').addEventListener('click', deletePrev);
   document.getElementById('btnDeleteAll').addEventListener('click', deleteAll);
+  document.getElementById('btnImport').addEventListener('click', importBackup);
+
+  // angezeigte Woche regelmäßig nachladen (nur neue Bytes)
+  setInterval(() => {
+    if (currentWeek && document.visibilityState === 'visible') loadWeek(currentWeek);
+  }, 60000);
 
   // Woche aus URL laden
   const params = new URLSearchParams(window.location.search);
@@ -4,8 +4,17 @@
 
 #include <Arduino.h>
 #include <LittleFS.h>
+#include <ESP8266WiFi.h>
+#include "lib/Backoff.h"
+#include "lib/Journal.h"
+#include "lib/LowPower.h"
+#include "lib/PowerControl.h"
+#include "lib/RecordFormat.h"
+#include "lib/RingBuffer.h"
+#include "lib/Scheduler.h"
 #include "lib/Sensor.h"
 #include "lib/Storage.h"
+#include "lib/Summary.h"
 #include "lib/Utils.h"
 #include "lib/Webserver.h"
 
@@ -14,41 +23,97 @@
 #define DEFAULT_WIFI_SSID "DEIN_WLAN"
 #define DEFAULT_WIFI_PASS "DEIN_PASSWORT"
 #define DEFAULT_HTTP_PASSWORD "admin" // für Lösch-APIs (falls genutzt)
-
-// RAM-Puffergröße (Anzahl Measurements vor Batch-Write)
-#define BUFFER_SIZE 10
+#define DEFAULT_LOW_POWER false
+
+// Timeouts for WiFi/NTP during a low-power WiFi window (battery must not drain on a missing AP)
+#define LOWPOWER_WIFI_TIMEOUT_MS 20000UL
+#define LOWPOWER_NTP_TIMEOUT_MS  10000UL
+// Normal mode: setup() continues without WiFi/NTP after these (retried in the background).
+// WIFI_CONNECT_TIMEOUT_MS also bounds each attempt of a live credentials change
+#define WIFI_CONNECT_TIMEOUT_MS 30000UL
+#define NTP_TIMEOUT_MS          15000UL
+// Shorter sleeps are not worth the wake-up cost, the sample moves to the following slot
+#define LOWPOWER_MIN_SLEEP_SECONDS 10
+
+// RAM-Puffergröße (Anzahl Measurements vor Batch-Write). Pending samples are journaled
+// (lib/Journal.h), so a reset does not lose them and batches can be large.
+// Kapazität des Ringpuffers (Zweierpotenz); Reserve, falls Flash-Schreiben hängt oder fehlschlägt
+#if JOURNAL_FLASH_LOG
+#define BUFFER_SIZE 240
+#define RING_CAPACITY 512
+#else
+#define BUFFER_SIZE 72   // 6 h at 5 min, fits into RTC memory
+#define RING_CAPACITY 128
+#endif
+static_assert(BUFFER_SIZE <= JOURNAL_CAPACITY, "BUFFER_SIZE exceeds the journal");
+static_assert(BUFFER_SIZE < RING_CAPACITY, "RING_CAPACITY leaves no reserve");
+static_assert(JOURNAL_CAPACITY <= RING_CAPACITY, "samples kept by Journal::replay must fit into the RAM buffer");
+// Records written per loop() iteration while a flush is running
+#define FLUSH_STEP_RECORDS 24
+// Wait before retrying after a failed flush step
+#define FLUSH_RETRY_MS 10000UL
 
 // Globale Objekte
 Sensor sensor;
 Storage storage;
 Utils utils;
 WebserverHandler webserver;
+EspPowerControl powerControl;
+RtcBuffer rtcBuffer(powerControl); // one RTC image: journal in normal mode, sample buffer in low-power mode
+LowPower lowPower(powerControl, rtcBuffer);
+Journal journal(rtcBuffer);
+Scheduler scheduler;
+Summary summary;
 
 ////////////////////
 // IDEE: BUFFER SIZE AN MESSINTERVALL ANPASSEN => KONSTANTE ZAHL VON SCHREIBZYKLEN PRO ZEIT
 ////////////////////
-// RAM-Puffer
-Measurement buffer[BUFFER_SIZE];
-uint8_t bufferCount = 0;
-
-// Timer
-unsigned long lastMeasureMillis = 0;
-unsigned long measureIntervalMs = DEFAULT_INTERVAL_SECONDS * 1000UL;
-
-// Settings (werden aus settings.json geladen, falls vorhanden)
-String g_wifi_ssid = DEFAULT_WIFI_SSID;
-String g_wifi_pass = DEFAULT_WIFI_PASS;
-uint32_t g_interval_seconds = DEFAULT_INTERVAL_SECONDS;
-String g_http_password = DEFAULT_HTTP_PASSWORD;
+// RAM-Puffer (Producer: performMeasurement, Consumer: flushStep/flushBuffer)
+RingBuffer<Measurement, RING_CAPACITY> buffer;
+bool flushInProgress = false;
+Backoff flushBackoff(FLUSH_RETRY_MS); // after a failed flush, wrap-safe
+
+// Settings (einmal beim Start aus settings.json geladen, danach nur noch im RAM gelesen)
+Settings g_settings = {
+  DEFAULT_INTERVAL_SECONDS,
+  DEFAULT_WIFI_SSID,
+  DEFAULT_WIFI_PASS,
+  DEFAULT_HTTP_PASSWORD,
+  DEFAULT_LOW_POWER
+};
+
+// true if this boot runs duty-cycled (measurements go to RTC memory instead of the RAM buffer)
+bool lowPowerCycle = false;
+unsigned long wifiWindowStart = 0;
+
+// Set by the webserver when new WiFi credentials arrive, applied in loop()
+bool wifiReconnectPending = false;
+// Credentials that connected last; restored if new ones from the web UI do not work
+String wifiGoodSsid;
+String wifiGoodPass;
+// Live credentials change, polled from loop() (never waits for the access point)
+enum WifiChangeStep { WIFI_CHANGE_IDLE, WIFI_CHANGE_TRY_NEW, WIFI_CHANGE_TRY_PREVIOUS };
+WifiChangeStep wifiChangeStep = WIFI_CHANGE_IDLE;
+unsigned long wifiChangeStart = 0;
+// Outcome of the last live credentials change, for the status API
+const char* wifiChangeState = "none";
 
 // Strict mode flag
 bool strictModeEnabled = true; // falls true: kein Logging wenn Jahr < 2020
 
 // Forward declaration
 void applyInterval();
+bool lowPowerActive();
+void requestWifiReconnect();
+void applyWifiSettings();
+void pollWifiChange();
 void flushBuffer();
-void performMeasurement();
+void flushStep();
+void performMeasurement(uint32_t scheduledTs);
+void sleepUntilNextSample();
 void blinkLed(unsigned long duration);
+void summarizeFlushed(const Measurement* arr, uint8_t len);
+void restoreUnwritten(const Measurement* arr, uint8_t len);
 
 void setup() {
   Serial.begin(115200);
@@ -66,33 +131,79 @@ void setup() {
   // Storage init
   storage.begin();
 
+#ifdef DATALOGGER_BENCH
+  benchRecordFormat();
+#endif
+
   // Utils init (WiFi & NTP)
   utils.begin();
 
   // Load settings from LittleFS (settings.json)
-  if (!storage.loadSettings(g_interval_seconds, g_wifi_ssid, g_wifi_pass, g_http_password)) {
+  if (!storage.loadSettings(g_settings)) {
     Serial.println(F("Error in Storage.loadSettings, using defaults."));
   }
 
   // Apply interval
   applyInterval();
 
+  // A reset (not a deep-sleep wake-up) can leave samples that never reached flash:
+  // the journaled RAM buffer, or the RTC buffer of the low-power mode (same RTC image)
+  bool deepSleepWake = powerControl.wokeFromDeepSleep();
+  summary.load(deepSleepWake);
+  if (!deepSleepWake) {
+    journal.setReplayedCallback(summarizeFlushed);
+    journal.setKeptCallback(restoreUnwritten);
+    journal.replay(storage);
+    summary.save();
+    // Kept samples are back in the RAM buffer and still journaled: like every buffered
+    // sample they count from now on, but not in the checkpoint (a reset replays them again)
+    const Measurement* kept;
+    uint32_t keptCount = buffer.peek(kept); // buffer was empty, so they are contiguous
+    for (uint32_t i = 0; i < keptCount; i++) summary.add(kept[i]);
+  }
+
+  // RTC-buffered samples (low-power mode) enter the summary when they go to flash
+  lowPower.setFlushedCallback(summarizeFlushed);
+
+  // Low-power mode: most wake-ups only measure into RTC memory and go back to sleep
+  if (lowPowerActive()) {
+    lowPowerCycle = true;
+    if (lowPower.begin()) {
+      utils.setEpoch(lowPower.estimatedEpoch());
+    }
+    if (!lowPower.wifiDue()) {
+      sensor.begin();
+      // timed wake-up lands on the slot boundary (give or take the RTC drift)
+      performMeasurement(scheduler.nearestSlot(utils.getEpoch()));
+      sleepUntilNextSample();
+      return; // not reached on the ESP (wake-up is a reset)
+    }
+    Serial.println(F("Low-power mode: WiFi window"));
+    // bring flash and summary up to date for the web UI
+    lowPower.flush(storage);
+    summary.save();
+  }
+  storage.debugListFiles(); // not on measure-only wake-ups, they keep the awake time short
+
   // Connect WiFi (non-blocking attempt inside utils)
-  utils.connectWiFi(g_wifi_ssid.c_str(), g_wifi_pass.c_str());
+  bool wifiOk = utils.connectWiFi(g_settings.wifiSsid.c_str(), g_settings.wifiPass.c_str(),
+                                  lowPowerCycle ? LOWPOWER_WIFI_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS);
+  // Wrong or outdated credentials: keep the web UI reachable to fix them (not on battery)
+  if (!wifiOk && !lowPowerCycle) utils.startConfigAP();
 
   // init NTP (will be attempted in utils)
-  utils.initNTP();
+  utils.initNTP(lowPowerCycle ? LOWPOWER_NTP_TIMEOUT_MS : NTP_TIMEOUT_MS);
 
   // Sensor init
   sensor.begin();
 
   // Webserver init (serves files from LittleFS/data)
-  webserver.begin(&storage, &utils, g_http_password);
+  webserver.begin(&storage, &utils);
   webserver.setIntervalChangedCallback(applyInterval);
+  webserver.setWifiChangedCallback(requestWifiReconnect);
   webserver.setFlushCallback(flushBuffer);
-
-  // Start measure timer immediately (first measurement after interval)
-  lastMeasureMillis = millis();
+  webserver.setScheduler(&scheduler);
+  webserver.setSummary(&summary);
 
   digitalWrite(LED_BUILTIN, HIGH); // Ensure LED starts off after setup
   Serial.println(F("Setup complete."));
@@ -101,35 +212,82 @@ void setup() {
   blinkLed(300);
   blinkLed(300);
 
-  // Perform first Measurement
-  performMeasurement();
+  // First reading only for the live display, logged samples follow the slot boundaries
+  performMeasurement(0);
+  wifiWindowStart = millis();
 }
 
 void loop() {
-  // Periodic tasks from utils (NTP check, reconnection attempts)
-  utils.handle();
+  if (lowPowerCycle) {
+    if (!lowPowerActive()) {
+      // switched off via settings: RTC records go to flash, continue in normal mode. The
+      // journal takes over the shared RTC image, so only once it is empty (else retry later)
+      if (!flushBackoff.waiting(millis())) {
+        if (lowPower.flush(storage)) {
+          flushBackoff.clear();
+          summary.save();
+          lowPowerCycle = false;
+        } else {
+          Serial.println(F("ERROR: Failed to flush RTC buffer, staying in low-power mode"));
+          flushBackoff.fail(millis());
+        }
+      }
+    } else if (webserver.isMeasurementActive() && millis() - wifiWindowStart >= LOWPOWER_WIFI_WINDOW_MS) {
+      lowPower.wifiDone();
+      sleepUntilNextSample();
+      return;
+    }
+  } else if (lowPowerActive() && !flushBackoff.waiting(millis())) {
+    // switched on via settings: the RAM buffer goes to flash, this session becomes the
+    // WiFi window and the device sleeps when it ends
+    flushBuffer();
+    if (buffer.empty()) {
+      Serial.println(F("Low-power mode on: deep sleep after this WiFi window"));
+      lowPowerCycle = true;
+      wifiWindowStart = millis();
+    }
+  }
+
+  // Periodic tasks from utils (NTP check, reconnection attempts). A low-power WiFi window
+  // only gets the attempt from setup(): without an AP it must still end on time. A running
+  // credentials change has its own attempt and timeout
+  if (!lowPowerCycle && wifiChangeStep == WIFI_CHANGE_IDLE) utils.handle();
 
   // Handle web server
   webserver.handleClient();
 
+  // New WiFi credentials: reconnect only after the settings response went out
+  if (wifiReconnectPending) {
+    wifiReconnectPending = false;
+    applyWifiSettings();
+  } else if (wifiChangeStep != WIFI_CHANGE_IDLE) {
+    pollWifiChange();
+  } else if (WiFi.status() == WL_CONNECTED &&
+             (wifiGoodSsid != g_settings.wifiSsid || wifiGoodPass != g_settings.wifiPass)) {
+    wifiGoodSsid = g_settings.wifiSsid;
+    wifiGoodPass = g_settings.wifiPass;
+  }
+
   if (webserver.isMeasurementActive()) {
-    // Measurement (non-blocking)
-    unsigned long nowMs = millis();
-    if ((nowMs - lastMeasureMillis) >= measureIntervalMs) {
-      lastMeasureMillis = nowMs;
-      performMeasurement();
+    // Measurement (non-blocking), stamped with its scheduled slot time
+    uint32_t scheduledTs;
+    if (scheduler.due(scheduledTs)) {
+      performMeasurement(scheduledTs);
     }
 
     // Optionally: flush buffer periodically if not full for graceful shutdown safeguards
     // (e.g., every minute) - optional
     // (skipped here to minimize flash writes)
   }
+
+  // Write a few buffered records per iteration (never blocks acquisition for a whole batch)
+  flushStep();
 }
 
-// Perform a measurement and push into buffer (then flush when buffer full)
-void performMeasurement() {
-  // Update current timestamp (NTP-backed if available)
-  time_t ts = utils.getEpoch();
+// Perform a measurement and push into buffer (then flush when buffer full).
+// scheduledTs is the slot the sample belongs to; 0 = only update the live value
+void performMeasurement(uint32_t scheduledTs) {
+  time_t ts = scheduledTs ? (time_t)scheduledTs : utils.getEpoch();
   tm timeinfo;
   gmtime_r(&ts, &timeinfo);
   int year = timeinfo.tm_year + 1900;
@@ -141,62 +299,219 @@ void performMeasurement() {
   }
 
   // Read sensor (the Sensor class handles retries & NaN filtering)
-  float t = NAN, h = NAN;
-  bool ok = sensor.read(t, h);
+  Measurement m = { (uint32_t)ts, NAN, NAN };
+  bool ok = sensor.read(m);
 
-  if (!ok || isnan(t) || isnan(h)) {
+  if (!ok) {
     Serial.println(F("Sensor read failed or NaN - measurement discarded"));
     return;
   }
 
   // Print with ts if available, else without ts
   if (ts) {
-    Serial.printf("Measured: %.1f C, %.1f %% at %lu\n", t, h, (unsigned long)ts);
-    webserver.updateLastMeasurement(t, h, ts);
+    Serial.printf("Measured: %.1f C, %.1f %% at %lu\n", m.temp, m.hum, (unsigned long)ts);
+    webserver.updateLastMeasurement(m);
   } else {
-    Serial.printf("Measured: %.1f C, %.1f %%\n", t, h);
+    Serial.printf("Measured: %.1f C, %.1f %%\n", m.temp, m.hum);
   }
   // Serial.printf("Measured: %.1f C, %.1f %%\n", t, h);
+
+  if (scheduledTs == 0) return;
+
+  if (lowPowerCycle) {
+    // RTC memory instead of the RAM buffer, flushed to flash by LowPower when full
+    if (!lowPower.record(m, storage)) {
+      Serial.println(F("ERROR: Failed to buffer measurement in RTC memory"));
+    }
+    return;
+  }
   blinkLed(500);
 
-  // Push to buffer
-  buffer[bufferCount].ts = (uint32_t)ts;
-  buffer[bufferCount].temp = t;
-  buffer[bufferCount].hum = h;
-  bufferCount++;
+  // Push to buffer (flushStep() in loop() writes it out once BUFFER_SIZE is reached)
+  if (!buffer.push(m)) {
+    Serial.printf("ERROR: Buffer full, sample dropped (%lu dropped so far)\n", (unsigned long)buffer.overflows());
+    return;
+  }
+  summary.add(m);
 
-  if (bufferCount >= BUFFER_SIZE) {
-    flushBuffer();
+  // The journal holds the oldest samples in order, so it only takes this one if it had all
+  // the others. Otherwise flushStep() starts at once, as the sample is not protected
+  if (journal.count() + 1U == buffer.size() && !journal.append(m)) {
+    Serial.println(F("Journal full, flushing early"));
   }
 }
 
 // Set the measurement interval
 void applyInterval() {
-    measureIntervalMs = (unsigned long)g_interval_seconds * 1000UL;
-    Serial.printf("Measurement interval set: every %lu s\n", (unsigned long)(measureIntervalMs) / 1000UL);
+    scheduler.setInterval(g_settings.intervalSeconds);
+    lowPower.setInterval(g_settings.intervalSeconds);
+    Serial.printf("Measurement interval set: every %lu s\n", (unsigned long)g_settings.intervalSeconds);
 }
 
-// Flush RAM buffer to LittleFS (writes batch)
-void flushBuffer() {
-  if (bufferCount == 0) {
-    Serial.println(F("Buffer is empty. Nothing to flush to storage"));
+// Deep sleep until shortly before the next slot boundary (low-power mode)
+void sleepUntilNextSample() {
+  time_t now = utils.getEpoch();
+  summary.save(); // only writes if an RTC flush added samples
+  lowPower.sleep(now, scheduler.secondsUntilNext(now, LOWPOWER_MIN_SLEEP_SECONDS));
+}
+
+// Deep-sleep duty cycling only pays off for long intervals
+bool lowPowerActive() {
+  return g_settings.lowPower && g_settings.intervalSeconds >= LOWPOWER_MIN_INTERVAL_SECONDS;
+}
+
+// Called by the webserver after the WiFi credentials in g_settings changed
+void requestWifiReconnect() {
+  wifiReconnectPending = true;
+}
+
+// Start connecting with the credentials from the web UI. pollWifiChange() follows the
+// attempt from loop(), so sampling, flushing and the web server keep running meanwhile
+void applyWifiSettings() {
+  Serial.println(F("WiFi settings changed, reconnecting..."));
+  delay(100); // let the settings response leave before the connection drops
+  WiFi.disconnect();
+  utils.connectWiFi(g_settings.wifiSsid.c_str(), g_settings.wifiPass.c_str()); // only starts
+  wifiChangeStep = WIFI_CHANGE_TRY_NEW;
+  wifiChangeStart = millis();
+  wifiChangeState = "connecting";
+}
+
+// Bounded by WIFI_CONNECT_TIMEOUT_MS per attempt. If the new credentials do not work, the
+// last working ones are restored (in settings.json too), else the config access point opens
+void pollWifiChange() {
+  if (WiFi.status() == WL_CONNECTED) {
+    Serial.print(F("WiFi connected, IP: "));
+    Serial.println(WiFi.localIP());
+    if (wifiChangeStep == WIFI_CHANGE_TRY_NEW) wifiChangeState = "ok";
+    wifiChangeStep = WIFI_CHANGE_IDLE;
+    return;
+  }
+  if (millis() - wifiChangeStart < WIFI_CONNECT_TIMEOUT_MS) return;
+
+  if (wifiChangeStep == WIFI_CHANGE_TRY_NEW && wifiGoodSsid.length() > 0 &&
+      (wifiGoodSsid != g_settings.wifiSsid || wifiGoodPass != g_settings.wifiPass)) {
+    Serial.println(F("New WiFi credentials failed, restoring the previous ones"));
+    wifiChangeState = "reverted";
+    g_settings.wifiSsid = wifiGoodSsid;
+    g_settings.wifiPass = wifiGoodPass;
+    if (!storage.saveSettings(g_settings)) {
+      Serial.println(F("ERROR: cannot save restored WiFi settings"));
+    }
+    WiFi.disconnect();
+    utils.connectWiFi(g_settings.wifiSsid.c_str(), g_settings.wifiPass.c_str());
+    wifiChangeStep = WIFI_CHANGE_TRY_PREVIOUS;
+    wifiChangeStart = millis();
     return;
   }
 
-  // Build array to write
-  Measurement tmp[BUFFER_SIZE];
-  memcpy(tmp, buffer, sizeof(Measurement)*bufferCount);
+  if (wifiChangeStep == WIFI_CHANGE_TRY_NEW) {
+    Serial.println(F("New WiFi credentials failed"));
+    wifiChangeState = "failed";
+  } else {
+    Serial.println(F("Previous WiFi credentials failed too"));
+  }
+  wifiChangeStep = WIFI_CHANGE_IDLE; // utils.handle() keeps retrying in the background
+  if (!lowPowerCycle) utils.startConfigAP();
+}
 
-  // Attempt to save; Storage will check 85% rule and delete oldest files if necessary
-  bool saved = storage.saveBatch(tmp, bufferCount);
+// Incremental flush: once BUFFER_SIZE records are pending (or one is not journaled),
+// write at most FLUSH_STEP_RECORDS per call until the buffer is empty
+void flushStep() {
+  if (!flushInProgress) {
+    if (buffer.size() < BUFFER_SIZE && journal.count() == buffer.size()) return;
+    if (flushBackoff.waiting(millis())) return;
+    flushInProgress = true;
+  }
 
-  if (saved) {
-    Serial.printf("Flushed %u entries to storage\n", bufferCount);
-    bufferCount = 0;
+  const Measurement* first;
+  uint32_t n = buffer.peek(first);
+  if (n == 0) {
+    flushInProgress = false;
+    summary.save(); // checkpoint once per flush run
+    return;
+  }
+  if (n > FLUSH_STEP_RECORDS) n = FLUSH_STEP_RECORDS;
+
+  // Records leave the buffer only after they are on flash (a failed batch may have
+  // written its first weeks; those must not be written again by the retry)
+  uint8_t written;
+  bool ok = storage.saveBatch(first, (uint8_t)n, &written);
+  buffer.pop(written);
+  journal.consume(written);
+  if (ok) {
+    flushBackoff.clear();
   } else {
-    Serial.println(F("ERROR: Failed to flush buffer to storage"));
-    // Keep buffer (to retry later) - but risk of data loss if reboot
+    Serial.println(F("ERROR: Failed to flush buffer to storage, retrying later"));
+    flushInProgress = false;
+    flushBackoff.fail(millis());
+  }
+}
+
+// Flush RAM buffer to LittleFS completely (user request / measurement stopped)
+void flushBuffer() {
+  if (lowPowerCycle && lowPower.buffered() > 0) {
+    if (lowPower.flush(storage)) {
+      Serial.println(F("Flushed RTC buffer to storage"));
+    }
   }
+
+  if (buffer.empty()) {
+    summary.save();
+    Serial.println(F("Buffer is empty. Nothing to flush to storage"));
+    return;
+  }
+
+  uint32_t flushed = 0;
+  const Measurement* first;
+  uint32_t n;
+  while ((n = buffer.peek(first)) > 0) {
+    if (n > 255) n = 255;
+    // Attempt to save; Storage will check 85% rule and delete oldest files if necessary
+    uint8_t written;
+    bool ok = storage.saveBatch(first, (uint8_t)n, &written);
+    buffer.pop(written);
+    journal.consume(written);
+    flushed += written;
+    if (!ok) {
+      Serial.println(F("ERROR: Failed to flush buffer to storage"));
+      // Keep the rest of the buffer (to retry later) - but risk of data loss if reboot
+      flushBackoff.fail(millis());
+      return;
+    }
+  }
+  flushInProgress = false;
+  flushBackoff.clear();
+  // only now: a saved summary must not contain samples that are still journaled
+  summary.save();
+  Serial.printf("Flushed %lu entries to storage\n", (unsigned long)flushed);
+}
+
+// RTC records that reached flash (low-power mode) feed the running statistics
+void summarizeFlushed(const Measurement* arr, uint8_t len) {
+  for (uint8_t i = 0; i < len; i++) summary.add(arr[i]);
+}
+
+// Journaled samples the replay could not write (e.g. flash full) go back into the RAM
+// buffer; they stay journaled and are written by the next flush. setup() adds them to
+// the summary after its checkpoint
+void restoreUnwritten(const Measurement* arr, uint8_t len) {
+  for (uint8_t i = 0; i < len; i++) buffer.push(arr[i]);
+}
+
+// Result of the last WiFi credentials change for the status API: none, connecting, ok,
+// reverted, failed
+const char* wifiChangeResult() {
+  return wifiChangeState;
+}
+
+// Buffer state for the status API
+uint32_t bufferedSamples() {
+  return buffer.size();
+}
+
+uint32_t droppedSamples() {
+  return buffer.overflows();
 }
 
 // Turn the global LED ON for a specified duration, default duration is 500 ms
@@ -0,0 +1,26 @@
+// lib/Backoff.h
+#pragma once
+#include <Arduino.h>
+
+// Wait period after a failure (e.g. a flash write), polled with millis().
+// Only the time since the failure is compared, in uint32_t like millis() on the ESP8266,
+// so the gate keeps working across the 49-day wrap and after weeks without a failure.
+// An absolute deadline compared as (long)(now - deadline) turns negative after 24.9 days.
+class Backoff {
+public:
+  explicit Backoff(uint32_t waitMs) : waitMs(waitMs) {}
+
+  void fail(uint32_t now) {
+    active = true;
+    failedAt = now;
+  }
+  void clear() { active = false; }
+
+  // True while the wait after the last failure is running
+  bool waiting(uint32_t now) const { return active && now - failedAt < waitMs; }
+
+private:
+  const uint32_t waitMs;
+  bool active = false;      // a failure since the last success
+  uint32_t failedAt = 0;    // millis() of that failure
+};
@@ -0,0 +1,272 @@
+// lib/Gzip.cpp
+#include "Gzip.h"
+#include <new>
+
+#define WSIZE       (1U << GZIP_WINDOW_BITS)
+#define WMASK       (WSIZE - 1)
+#define HASH_SIZE   (1U << GZIP_HASH_BITS)
+#define MIN_MATCH   3
+#define MAX_MATCH   258
+// Input kept ahead of pos so every match can reach MAX_MATCH (as in zlib)
+#define MIN_LOOKAHEAD (MAX_MATCH + MIN_MATCH + 1)
+#define MAX_DIST    (WSIZE - MIN_LOOKAHEAD)
+// Matches at least this long are taken without looking at the next position
+#define GZIP_LAZY_LIMIT 32
+
+static_assert(GZIP_WINDOW_BITS >= 9 && GZIP_WINDOW_BITS <= 15, "GZIP_WINDOW_BITS out of range");
+
+// Window buffer holds two windows: history (up to MAX_DIST) + lookahead/new input.
+// head/prev store window positions, 0 = empty (position 0 is never matched against)
+struct GzipEncoder::State {
+  uint8_t window[2 * WSIZE];
+  uint16_t head[HASH_SIZE];
+  uint16_t prev[WSIZE];
+  uint8_t outBuf[GZIP_OUT_BUFFER];
+};
+
+// Length codes 257..285: base length and extra bits (RFC 1951 3.2.5)
+static const uint16_t LENGTH_BASE[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+// Distance codes 0..29
+static const uint16_t DIST_BASE[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DIST_EXTRA[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// CRC-32 (gzip polynomial) with a 16 entry table: 64 bytes of RAM instead of 1 KB
+static const uint32_t CRC_NIBBLE[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ CRC_NIBBLE[crc & 15];
+    crc = (crc >> 4) ^ CRC_NIBBLE[crc & 15];
+  }
+  return ~crc;
+}
+
+// Huffman codes are sent most significant bit first, everything else LSB first
+static uint16_t reverseBits(uint16_t code, uint8_t len) {
+  uint16_t r = 0;
+  while (len--) {
+    r = (r << 1) | (code & 1);
+    code >>= 1;
+  }
+  return r;
+}
+
+static inline uint16_t hash3(const uint8_t* p) {
+  uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+  return (uint16_t)((uint32_t)(v * 2654435761UL) >> (32 - GZIP_HASH_BITS));
+}
+
+GzipEncoder::GzipEncoder(Print& o) : out(o) {}
+
+GzipEncoder::~GzipEncoder() {
+  delete s;
+}
+
+bool GzipEncoder::begin() {
+  if (!s) s = new (std::nothrow) State;
+  if (!s) return false;
+  memset(s->head, 0, sizeof(s->head));
+  memset(s->prev, 0, sizeof(s->prev));
+  pos = end = 0;
+  bitBuf = 0;
+  bitCount = 0;
+  outLen = 0;
+  crc = 0;
+  inBytes = outBytes = 0;
+  cpuUs = printUs = 0;
+  failed = false;
+
+  // gzip header: magic, deflate, no flags, no mtime, no extra flags, OS unknown
+  static const uint8_t header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+  for (uint8_t b : header) putByte(b);
+  // one final block with fixed Huffman codes for the whole stream
+  putBits(1, 1);
+  putBits(1, 2);
+  return true;
+}
+
+bool GzipEncoder::write(const uint8_t* data, size_t len) {
+  if (!s || failed) return false;
+  uint32_t start = micros();
+  uint32_t printStart = printUs;
+
+  crc = crc32Update(crc, data, len);
+  inBytes += len;
+  while (len > 0) {
+    if (end == 2 * WSIZE) slide();
+    size_t n = 2 * WSIZE - end;
+    if (n > len) n = len;
+    memcpy(s->window + end, data, n);
+    end += n;
+    data += n;
+    len -= n;
+    process(false);
+  }
+
+  cpuUs += (micros() - start) - (printUs - printStart);
+  return !failed;
+}
+
+bool GzipEncoder::finish() {
+  if (!s || failed) return false;
+  uint32_t start = micros();
+  uint32_t printStart = printUs;
+
+  process(true);
+  putSymbol(256);                      // end of block
+  if (bitCount > 0) putBits(0, 8 - bitCount);
+  for (uint8_t i = 0; i < 4; i++) putByte((uint8_t)(crc >> (8 * i)));
+  for (uint8_t i = 0; i < 4; i++) putByte((uint8_t)(inBytes >> (8 * i)));
+  flushOut();
+
+  cpuUs += (micros() - start) - (printUs - printStart);
+  delete s;
+  s = nullptr;
+  return !failed;
+}
+
+// Drop the oldest window; positions in the hash chains move down by WSIZE
+void GzipEncoder::slide() {
+  memmove(s->window, s->window + WSIZE, WSIZE);
+  pos -= WSIZE;
+  end -= WSIZE;
+  for (uint16_t& h : s->head) h = h >= WSIZE ? h - WSIZE : 0;
+  for (uint16_t& p : s->prev) p = p >= WSIZE ? p - WSIZE : 0;
+}
+
+void GzipEncoder::insertHash(uint32_t p) {
+  uint16_t h = hash3(s->window + p);
+  s->prev[p & WMASK] = s->head[h];
+  s->head[h] = (uint16_t)p;
+}
+
+// Longest match for position p among the last GZIP_MAX_CHAIN positions with the same hash
+// (cand = newest of them). Returns the length (0 if below MIN_MATCH), dist is set on a match
+uint16_t GzipEncoder::longestMatch(uint32_t p, uint32_t cand, uint16_t& dist) {
+  const uint8_t* w = s->window;
+  uint32_t maxLen = end - p < MAX_MATCH ? end - p : MAX_MATCH;
+  uint16_t bestLen = MIN_MATCH - 1;
+  uint8_t chain = GZIP_MAX_CHAIN;
+  while (cand > 0 && chain-- > 0) {
+    uint32_t d = p - cand;
+    if (d > MAX_DIST) break;
+    if (w[cand + bestLen] == w[p + bestLen] && w[cand] == w[p]) {
+      uint32_t len = 1;
+      while (len < maxLen && w[cand + len] == w[p + len]) len++;
+      if (len > bestLen) {
+        bestLen = (uint16_t)len;
+        dist = (uint16_t)d;
+        if (len == maxLen) break;
+      }
+    }
+    cand = s->prev[cand & WMASK];
+  }
+  return bestLen >= MIN_MATCH ? bestLen : 0;
+}
+
+// LZ77 with one step of lazy matching: a match is only taken if the next position does
+// not start a longer one (~12 % smaller CSV output than greedy matching)
+void GzipEncoder::process(bool flush) {
+  while (pos < end && (flush || end - pos >= MIN_LOOKAHEAD)) {
+    uint16_t len = 0;
+    uint16_t dist = 0;
+
+    if (end - pos >= MIN_MATCH) {
+      uint16_t h = hash3(s->window + pos);
+      uint32_t cand = s->head[h];
+      s->prev[pos & WMASK] = (uint16_t)cand;
+      s->head[h] = (uint16_t)pos;
+      len = longestMatch(pos, cand, dist);
+
+      if (len > 0 && len < GZIP_LAZY_LIMIT && end - (pos + 1) >= MIN_MATCH) {
+        uint16_t dist2 = 0;
+        uint16_t len2 = longestMatch(pos + 1, s->head[hash3(s->window + pos + 1)], dist2);
+        if (len2 > len) {
+          putLiteral(s->window[pos]);
+          pos++;
+          insertHash(pos);
+          len = len2;
+          dist = dist2;
+        }
+      }
+    }
+
+    if (len > 0) {
+      putMatch(len, dist);
+      // positions inside the match are still candidates for later matches
+      for (uint32_t i = 1; i < len; i++) {
+        if (pos + i + MIN_MATCH <= end) insertHash(pos + i);
+      }
+      pos += len;
+    } else {
+      putLiteral(s->window[pos]);
+      pos++;
+    }
+  }
+}
+
+void GzipEncoder::putBits(uint32_t value, uint8_t n) {
+  bitBuf |= value << bitCount;
+  bitCount += n;
+  while (bitCount >= 8) {
+    putByte((uint8_t)bitBuf);
+    bitBuf >>= 8;
+    bitCount -= 8;
+  }
+}
+
+// Fixed literal/length code (RFC 1951 3.2.6)
+void GzipEncoder::putSymbol(uint16_t sym) {
+  if (sym < 144)      putBits(reverseBits(0x30 + sym, 8), 8);
+  else if (sym < 256) putBits(reverseBits(0x190 + sym - 144, 9), 9);
+  else if (sym < 280) putBits(reverseBits(sym - 256, 7), 7);
+  else                putBits(reverseBits(0xC0 + sym - 280, 8), 8);
+}
+
+void GzipEncoder::putLiteral(uint8_t c) {
+  putSymbol(c);
+}
+
+void GzipEncoder::putMatch(uint16_t len, uint16_t dist) {
+  uint8_t lc = 28;
+  while (LENGTH_BASE[lc] > len) lc--;
+  putSymbol(257 + lc);
+  if (LENGTH_EXTRA[lc]) putBits(len - LENGTH_BASE[lc], LENGTH_EXTRA[lc]);
+
+  uint8_t dc = 29;
+  while (DIST_BASE[dc] > dist) dc--;
+  putBits(reverseBits(dc, 5), 5);
+  if (DIST_EXTRA[dc]) putBits(dist - DIST_BASE[dc], DIST_EXTRA[dc]);
+}
+
+void GzipEncoder::putByte(uint8_t b) {
+  s->outBuf[outLen++] = b;
+  if (outLen == GZIP_OUT_BUFFER) flushOut();
+}
+
+void GzipEncoder::flushOut() {
+  if (outLen == 0) return;
+  uint32_t start = micros();
+  if (!failed && out.write(s->outBuf, outLen) != outLen) failed = true;
+  printUs += micros() - start;
+  outBytes += outLen;
+  outLen = 0;
+}
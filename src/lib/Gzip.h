@@ -0,0 +1,73 @@
+// lib/Gzip.h
+#pragma once
+#include <Arduino.h>
+
+// LZ77 window: 2^GZIP_WINDOW_BITS bytes. RAM while compressing is about
+// 4 x window + 2 x hash table + output buffer (~6.6 KB for 10 bits), freed afterwards
+#ifndef GZIP_WINDOW_BITS
+  #define GZIP_WINDOW_BITS 10
+#endif
+#define GZIP_HASH_BITS 10
+// Candidates compared per position (more = better ratio, more CPU)
+#ifndef GZIP_MAX_CHAIN
+  #define GZIP_MAX_CHAIN 8
+#endif
+// Compressed bytes handed to the Print at once (about one TCP segment)
+#define GZIP_OUT_BUFFER 536
+
+// Totals over all compressed responses (for /api/status)
+struct GzipStats {
+  uint32_t responses;
+  uint32_t bytesIn;
+  uint32_t bytesOut;
+  uint64_t cpuUs;   // time spent compressing (excludes writing to the Print)
+};
+
+// Streaming gzip (RFC 1952/1951) encoder: lazy LZ77 over a small sliding window, one deflate
+// block with the fixed Huffman codes (no code tables to build or transmit). Input can be
+// fed in pieces of any size; the compressed stream goes to out in GZIP_OUT_BUFFER pieces.
+class GzipEncoder {
+public:
+  explicit GzipEncoder(Print& out);
+  ~GzipEncoder();
+
+  // Allocate the window and write the gzip header; false if the heap is too small
+  bool begin();
+
+  // Compress data; false once writing to out failed
+  bool write(const uint8_t* data, size_t len);
+
+  // Compress the rest, write end of block and trailer; false if writing to out failed
+  bool finish();
+
+  uint32_t bytesIn() const { return inBytes; }
+  uint32_t bytesOut() const { return outBytes; }
+  uint32_t cpuMicros() const { return cpuUs; }
+
+private:
+  struct State;
+  Print& out;
+  State* s = nullptr;
+  uint32_t pos = 0;       // next position to encode (in the window buffer)
+  uint32_t end = 0;       // end of the buffered input
+  uint32_t bitBuf = 0;
+  uint8_t bitCount = 0;
+  uint16_t outLen = 0;
+  uint32_t crc = 0;
+  uint32_t inBytes = 0;
+  uint32_t outBytes = 0;
+  uint32_t cpuUs = 0;
+  uint32_t printUs = 0;   // time spent in out.write(), subtracted from cpuUs
+  bool failed = false;
+
+  void process(bool flush);
+  void slide();
+  void insertHash(uint32_t p);
+  uint16_t longestMatch(uint32_t p, uint32_t cand, uint16_t& dist);
+  void putBits(uint32_t value, uint8_t n);
+  void putLiteral(uint8_t c);
+  void putSymbol(uint16_t sym);
+  void putMatch(uint16_t len, uint16_t dist);
+  void putByte(uint8_t b);
+  void flushOut();
+};
@@ -0,0 +1,185 @@
+// lib/Importer.cpp
+#include "Importer.h"
+#include "RecordFormat.h"
+
+// room for our own records plus values with more decimals from edited files
+static_assert(IMPORT_MAX_LINE > RECORD_MAX_LEN, "IMPORT_MAX_LINE too small for the record schema");
+
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t le32(const uint8_t* p) { return le16(p) | ((uint32_t)le16(p + 2) << 16); }
+
+Importer::Importer(Storage& s) : storage(s) {
+  begin();
+}
+
+void Importer::begin() {
+  format = FORMAT_UNKNOWN;
+  lineLen = 0;
+  lineOverflow = false;
+  zipState = ZIP_HEADER;
+  headerLen = 0;
+  remaining = 0;
+  dataSize = 0;
+  entryStored = false;
+  batchCount = 0;
+  weekKey = 0;
+  weekLastTs = 0;
+  recordCount = 0;
+  rejectedCount = 0;
+  skippedCount = 0;
+  byteCount = 0;
+  storeFailed = false;
+}
+
+void Importer::feed(const uint8_t* data, size_t len) {
+  if (len == 0 || storeFailed) return;
+  byteCount += len;
+  if (format == FORMAT_UNKNOWN) {
+    // ZIP files start with a local file header "PK\3\4"
+    format = (data[0] == 'P') ? FORMAT_ZIP : FORMAT_CSV;
+  }
+  if (format == FORMAT_ZIP) feedZip(data, len);
+  else feedCsv(data, len);
+}
+
+void Importer::feedZip(const uint8_t* data, size_t len) {
+  while (len > 0 && zipState != ZIP_DONE) {
+    switch (zipState) {
+      case ZIP_HEADER: {
+        size_t n = sizeof(header) - headerLen;
+        if (n > len) n = len;
+        memcpy(header + headerLen, data, n);
+        headerLen += n;
+        data += n;
+        len -= n;
+        if (headerLen < 4) break;
+        if (le32(header) != 0x04034b50UL) {
+          // central directory (or garbage): no more entries
+          zipState = ZIP_DONE;
+          break;
+        }
+        if (headerLen < sizeof(header)) break;
+
+        uint16_t flags = le16(header + 6);
+        uint16_t method = le16(header + 8);
+        dataSize = le32(header + 18); // compressed size
+        remaining = (uint32_t)le16(header + 26) + le16(header + 28); // name + extra
+        headerLen = 0;
+        if (flags & 0x08) {
+          // sizes only in a trailing data descriptor: cannot find the entry end while streaming
+          Serial.println(F("Importer: zip entries with data descriptor are not supported"));
+          rejectedCount++;
+          zipState = ZIP_DONE;
+          break;
+        }
+        entryStored = (method == 0);
+        if (!entryStored) {
+          Serial.println(F("Importer: skipping compressed zip entry (only stored entries)"));
+          rejectedCount++;
+        }
+        zipState = ZIP_SKIP;
+        break;
+      }
+      case ZIP_SKIP: {
+        size_t n = remaining < len ? remaining : len;
+        data += n;
+        len -= n;
+        remaining -= n;
+        if (remaining == 0) {
+          remaining = dataSize;
+          zipState = ZIP_DATA;
+        }
+        break;
+      }
+      case ZIP_DATA: {
+        size_t n = remaining < len ? remaining : len;
+        if (entryStored) feedCsv(data, n);
+        data += n;
+        len -= n;
+        remaining -= n;
+        if (remaining == 0) {
+          // entry done; a file not ending in '\n' must not merge into the next one
+          if (lineLen > 0 || lineOverflow) endLine();
+          zipState = ZIP_HEADER;
+        }
+        break;
+      }
+      case ZIP_DONE:
+        break;
+    }
+  }
+}
+
+void Importer::feedCsv(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    char c = (char)data[i];
+    if (c == '\n') {
+      endLine();
+    } else if (lineLen < IMPORT_MAX_LINE - 1) {
+      line[lineLen++] = c;
+    } else {
+      lineOverflow = true;
+    }
+  }
+}
+
+void Importer::endLine() {
+  if (lineOverflow) {
+    rejectedCount++;
+  } else if (lineLen > 0) {
+    Measurement m;
+    if (parseLine(m)) {
+      add(m);
+    } else {
+      rejectedCount++;
+    }
+  }
+  lineLen = 0;
+  lineOverflow = false;
+}
+
+bool Importer::parseLine(Measurement& m) {
+  if (lineLen > 0 && line[lineLen - 1] == '\r') lineLen--;
+  if (lineLen == 0) return false;
+  line[lineLen] = 0;
+  return parseRecord(line, m);
+}
+
+// Appending keeps the week file sorted only for records newer than its last one; older
+// records (already there, or out of order in the upload) are skipped
+void Importer::add(const Measurement& m) {
+  uint32_t key = Storage::weekKey((time_t)m.ts);
+  if (key != weekKey) {
+    flushBatch(); // the file must hold what this import wrote to it before
+    weekKey = key;
+    weekLastTs = storage.lastTimestampInWeek((time_t)m.ts);
+  }
+  if (m.ts <= weekLastTs) {
+    skippedCount++;
+    return;
+  }
+  weekLastTs = m.ts;
+  batch[batchCount++] = m;
+  if (batchCount >= IMPORT_BATCH_SIZE) flushBatch();
+}
+
+void Importer::flushBatch() {
+  if (batchCount == 0 || storeFailed) {
+    batchCount = 0;
+    return;
+  }
+  uint8_t written;
+  bool ok = storage.saveBatch(batch, batchCount, &written, false); // keep the old weeks
+  recordCount += written;
+  if (!ok) {
+    Serial.println(F("Importer: failed to store batch, aborting import"));
+    storeFailed = true;
+  }
+  batchCount = 0;
+}
+
+bool Importer::finish() {
+  if (format == FORMAT_CSV && (lineLen > 0 || lineOverflow)) endLine();
+  flushBatch();
+  return !storeFailed;
+}
@@ -0,0 +1,71 @@
+// lib/Importer.h
+#pragma once
+#include <Arduino.h>
+#include "Storage.h"
+
+// Records collected before one Storage::saveBatch call
+#define IMPORT_BATCH_SIZE 32
+// Longest accepted CSV line (longer lines are skipped as invalid)
+#define IMPORT_MAX_LINE 48
+
+// Streaming restore of a backup into Storage. Accepts either a plain "ts;temp;hum" CSV
+// (e.g. one week download) or the ZIP from "Download alle Wochen" (stored entries, as
+// written by JSZip by default). Input arrives in arbitrary chunks through feed(); only a
+// line buffer and one batch are held in RAM, never the upload itself.
+// Week files stay in timestamp order: a record is only stored if it is newer than the last
+// one in its week file, so importing the same backup twice adds nothing. Old weeks are
+// never deleted to make room for an import; a full flash ends it instead.
+class Importer {
+public:
+  explicit Importer(Storage& storage);
+
+  void begin();
+  void feed(const uint8_t* data, size_t len);
+  // Flush the last partial line/batch; returns false if storing failed
+  bool finish();
+
+  bool isZip() const { return format == FORMAT_ZIP; }
+  bool failed() const { return storeFailed; }
+  uint32_t records() const { return recordCount; }    // stored records
+  uint32_t rejected() const { return rejectedCount; }   // unparsable lines / unsupported zip entries
+  uint32_t skipped() const { return skippedCount; }     // not newer than their week file (duplicate, out of order)
+  uint32_t bytes() const { return byteCount; }
+
+private:
+  enum Format : uint8_t { FORMAT_UNKNOWN, FORMAT_CSV, FORMAT_ZIP };
+  enum ZipState : uint8_t { ZIP_HEADER, ZIP_SKIP, ZIP_DATA, ZIP_DONE };
+
+  Storage& storage;
+  Format format;
+
+  // CSV line assembly
+  char line[IMPORT_MAX_LINE];
+  uint8_t lineLen;
+  bool lineOverflow;
+
+  // ZIP local file header parsing
+  ZipState zipState;
+  uint8_t header[30];
+  uint8_t headerLen;
+  uint32_t remaining;  // bytes to skip (name/extra) or entry data left
+  uint32_t dataSize;   // size of the entry following the skipped name/extra
+  bool entryStored;    // entry is uncompressed -> feed to the CSV parser
+
+  Measurement batch[IMPORT_BATCH_SIZE]; // records of one week
+  uint8_t batchCount;
+  uint32_t weekKey;     // week of the batch (Storage::weekKey)
+  uint32_t weekLastTs;  // newest record of that week, in the file or in the batch
+
+  uint32_t recordCount;
+  uint32_t rejectedCount;
+  uint32_t skippedCount;
+  uint32_t byteCount;
+  bool storeFailed;
+
+  void feedZip(const uint8_t* data, size_t len);
+  void feedCsv(const uint8_t* data, size_t len);
+  void endLine();
+  bool parseLine(Measurement& m);
+  void add(const Measurement& m);
+  void flushBatch();
+};
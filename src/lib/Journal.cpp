@@ -0,0 +1,187 @@
+// lib/Journal.cpp
+#include "Journal.h"
+#include "RecordSchema.h"
+#include <LittleFS.h>
+
+#define JOURNAL_REPLAY_BATCH 16
+
+#if JOURNAL_FLASH_LOG
+// One sample in the flash log. ts == 0 marks a consume record: the hum10 oldest samples
+// reached flash. A torn entry at the end (power loss while appending) is ignored
+struct JournalEntry {
+  uint32_t ts;
+  int16_t temp10;
+  uint16_t hum10;
+};
+static_assert(sizeof(JournalEntry) == 8, "JournalEntry must be packed into 8 bytes");
+// like RtcRecord it holds exactly these two channels with one decimal
+static_assert(RECORD_CHANNEL_COUNT == 2 &&
+              RECORD_CHANNELS[0].field == &Measurement::temp && RECORD_CHANNELS[0].decimals == 1 &&
+              RECORD_CHANNELS[1].field == &Measurement::hum && RECORD_CHANNELS[1].decimals == 1,
+              "JournalEntry does not match the record schema");
+#endif
+
+Journal::Journal(RtcBuffer& r) : rtc(r) {}
+
+bool Journal::replayBatch(Storage& storage, const Measurement* batch, uint8_t n, uint8_t& written) {
+  bool ok = storage.saveBatch(batch, n, &written);
+  if (!ok) Serial.println(F("Journal: failed to replay samples to storage"));
+  if (written && replayedCallback) replayedCallback(batch, written);
+  return ok;
+}
+
+// Writes one batch unless an earlier one failed; from the first failure on, the samples are
+// handed to the kept callback in order. Adds the written ones to done
+void Journal::replayOrKeep(Storage& storage, const Measurement* batch, uint8_t n, bool& ok, uint16_t& done) {
+  uint8_t written = 0;
+  if (ok) ok = replayBatch(storage, batch, n, written);
+  done += written;
+  if (written < n && keptCallback) keptCallback(batch + written, n - written);
+}
+
+uint16_t Journal::replayRtc(Storage& storage) {
+  Measurement batch[JOURNAL_REPLAY_BATCH];
+  uint16_t done = 0;
+  bool ok = true;
+  for (uint16_t i = 0; i < rtc.count();) {
+    uint8_t n = rtc.count() - i < JOURNAL_REPLAY_BATCH ? rtc.count() - i : JOURNAL_REPLAY_BATCH;
+    for (uint8_t j = 0; j < n; j++) batch[j] = rtc.get(i + j);
+    replayOrKeep(storage, batch, n, ok, done);
+    i += n;
+  }
+  return done;
+}
+
+#if JOURNAL_FLASH_LOG
+uint16_t Journal::replayFlashLog(Storage& storage, uint16_t& total) {
+  total = 0;
+  File f = LittleFS.open(JOURNAL_FLASH_PATH, "r");
+  if (!f) return 0;
+
+  // first pass: how many of the logged samples were consumed already
+  JournalEntry e;
+  uint32_t consumed = 0;
+  uint32_t logged = 0;
+  while (f.read((uint8_t*)&e, sizeof(e)) == sizeof(e)) {
+    if (e.ts == 0) consumed += e.hum10;
+    else logged++;
+  }
+  total = logged > consumed ? logged - consumed : 0;
+
+  f.seek(0);
+  Measurement batch[JOURNAL_REPLAY_BATCH];
+  uint8_t n = 0;
+  uint16_t done = 0;
+  bool ok = true;
+  while (f.read((uint8_t*)&e, sizeof(e)) == sizeof(e)) {
+    if (e.ts == 0) continue;
+    if (consumed > 0) {
+      consumed--;
+      continue;
+    }
+    batch[n++] = { e.ts, e.temp10 / 10.0f, e.hum10 / 10.0f };
+    if (n == JOURNAL_REPLAY_BATCH) {
+      replayOrKeep(storage, batch, n, ok, done);
+      n = 0;
+    }
+  }
+  if (n > 0) replayOrKeep(storage, batch, n, ok, done);
+  f.close();
+  return done;
+}
+
+bool Journal::appendFlashLog(uint32_t ts, int16_t temp10, uint16_t hum10) {
+  File f = LittleFS.open(JOURNAL_FLASH_PATH, "a");
+  if (!f) return false;
+  JournalEntry e = { ts, temp10, hum10 };
+  bool ok = f.write((const uint8_t*)&e, sizeof(e)) == sizeof(e);
+  f.close();
+  return ok;
+}
+#endif
+
+uint16_t Journal::replay(Storage& storage) {
+  rtc.load(); // starts empty without a valid image (power loss)
+  uint16_t total = rtc.count();
+  uint16_t replayed;
+#if JOURNAL_FLASH_LOG
+  // the flash log holds every journaled sample, RTC memory only the oldest ones
+  bool haveLog = LittleFS.exists(JOURNAL_FLASH_PATH);
+  replayed = haveLog ? replayFlashLog(storage, total) : replayRtc(storage);
+#else
+  replayed = replayRtc(storage);
+#endif
+  if (replayed > 0) {
+    Serial.printf("Journal: replayed %u samples to storage\n", replayed);
+  }
+  if (replayed < total) {
+    Serial.printf("Journal: %u samples not written, kept for the next flush\n", total - replayed);
+  }
+
+  // Samples that could not be written stay journaled; the kept callback put them back
+  // into the RAM buffer, which the journal mirrors again from here on
+#if JOURNAL_FLASH_LOG
+  if (!haveLog && replayed < total) {
+    // only RTC memory had them: start a log with the kept ones, like append() would have
+    rtc.consume(replayed);
+    rtc.save();
+    LittleFS.remove(JOURNAL_FLASH_PATH);
+    for (uint16_t i = 0; i < rtc.count(); i++) {
+      Measurement m = rtc.get(i);
+      appendFlashLog(m.ts, (int16_t)lroundf(m.temp * 10.0f), (uint16_t)lroundf(m.hum * 10.0f));
+    }
+    pending = rtc.count();
+    flashOnly = 0;
+    return replayed;
+  }
+  if (rtc.count() > total) {
+    rtc.clear(); // stale RTC image that is not part of the log
+    rtc.save();
+  }
+  flashOnly = total - rtc.count();
+#endif
+  pending = total;
+  consume(replayed);
+  return replayed;
+}
+
+bool Journal::append(const Measurement& m) {
+  if (pending >= JOURNAL_CAPACITY) return false;
+#if JOURNAL_FLASH_LOG
+  if (!appendFlashLog(m.ts, (int16_t)lroundf(m.temp * 10.0f), (uint16_t)lroundf(m.hum * 10.0f))) {
+    Serial.println(F("Journal: flash log append failed"));
+    return false;
+  }
+  // RTC memory stays a prefix of the journal: once a sample went to flash only, so do all newer ones
+  if (flashOnly > 0 || !rtc.push(m)) {
+    flashOnly++;
+  } else {
+    rtc.save();
+  }
+#else
+  if (!rtc.push(m)) return false; // full, or too far from the oldest sample
+  rtc.save();
+#endif
+  pending++;
+  return true;
+}
+
+void Journal::consume(uint16_t n) {
+  if (n > pending) n = pending;
+  if (n == 0) return;
+
+  uint16_t fromRtc = n < rtc.count() ? n : rtc.count();
+  rtc.consume(fromRtc);
+  rtc.save();
+  flashOnly -= n - fromRtc;
+  pending -= n;
+
+#if JOURNAL_FLASH_LOG
+  // a failed consume record only means the samples are written twice after a reset
+  if (pending == 0) {
+    LittleFS.remove(JOURNAL_FLASH_PATH);
+  } else if (!appendFlashLog(0, 0, n)) {
+    Serial.println(F("Journal: flash log append failed"));
+  }
+#endif
+}
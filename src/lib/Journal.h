@@ -0,0 +1,61 @@
+// lib/Journal.h
+#pragma once
+#include <Arduino.h>
+#include "RtcBuffer.h"
+#include "Storage.h"
+
+// Optional append-only log on flash in addition to RTC memory. It also survives power loss
+// and holds more samples than RTC memory, but costs one small flash append per sample
+#ifndef JOURNAL_FLASH_LOG
+#define JOURNAL_FLASH_LOG 0
+#endif
+#define JOURNAL_FLASH_PATH "/journal.bin"
+#define JOURNAL_FLASH_CAPACITY 480
+
+#if JOURNAL_FLASH_LOG
+#define JOURNAL_CAPACITY JOURNAL_FLASH_CAPACITY
+#else
+#define JOURNAL_CAPACITY RTC_BUFFER_CAPACITY
+#endif
+
+// Write-ahead journal of the samples waiting in the RAM buffer, oldest first.
+// They are kept in RTC user memory (survives resets, crashes and watchdog resets), in the
+// same RtcBuffer as LowPower, and written to storage at the next boot. The journal only
+// appends while that buffer holds no low-power samples (see loop() in ESP_Datalogger.cpp).
+class Journal {
+public:
+  explicit Journal(RtcBuffer& rtc);
+
+  // After a reset (not a deep-sleep wake-up): write the journaled samples to storage.
+  // Samples that could not be written (e.g. flash full) stay journaled and go to the kept
+  // callback, which must put them back into the RAM buffer. Returns the number written
+  uint16_t replay(Storage& storage);
+
+  // Journal the newest buffered sample; false if it does not fit (flush the buffer first)
+  bool append(const Measurement& m);
+
+  // The n oldest journaled samples are on flash now
+  void consume(uint16_t n);
+
+  uint16_t count() const { return pending; }
+
+  // Called with every replayed batch that went to flash
+  void setReplayedCallback(void (*cb)(const Measurement* arr, uint8_t len)) { replayedCallback = cb; }
+  // Called with the samples replay() could not write, oldest first
+  void setKeptCallback(void (*cb)(const Measurement* arr, uint8_t len)) { keptCallback = cb; }
+
+private:
+  RtcBuffer& rtc;            // oldest journaled samples (shared with LowPower)
+  uint16_t pending = 0;      // all journaled samples
+  uint16_t flashOnly = 0;    // newer samples that only went to the flash log (RTC memory was full)
+  void (*replayedCallback)(const Measurement* arr, uint8_t len) = nullptr;
+  void (*keptCallback)(const Measurement* arr, uint8_t len) = nullptr;
+
+  bool replayBatch(Storage& storage, const Measurement* batch, uint8_t n, uint8_t& written);
+  void replayOrKeep(Storage& storage, const Measurement* batch, uint8_t n, bool& ok, uint16_t& done);
+  uint16_t replayRtc(Storage& storage);
+#if JOURNAL_FLASH_LOG
+  uint16_t replayFlashLog(Storage& storage, uint16_t& total);
+  bool appendFlashLog(uint32_t ts, int16_t temp10, uint16_t hum10);
+#endif
+};
@@ -0,0 +1,66 @@
+// lib/LowPower.cpp
+#include "LowPower.h"
+
+LowPower::LowPower(PowerControl& p, RtcBuffer& r) : power(p), rtc(r) {}
+
+bool LowPower::begin() {
+  bool valid = rtc.load();
+  resumedFromSleep = valid && power.wokeFromDeepSleep();
+  if (resumedFromSleep) {
+    rtc.raw().wakesSinceWifi++;
+  }
+  return resumedFromSleep;
+}
+
+void LowPower::setInterval(uint32_t seconds) {
+  uint32_t n = seconds ? LOWPOWER_WIFI_PERIOD_S / seconds : 1;
+  wifiEveryNWakes = n < 1 ? 1 : (n > 0xFFFF ? 0xFFFF : n);
+}
+
+time_t LowPower::estimatedEpoch() const {
+  const RtcState& s = rtc.raw();
+  return (time_t)(s.sleepEpoch + s.sleepSeconds + millis() / 1000UL);
+}
+
+bool LowPower::wifiDue() const {
+  if (!resumedFromSleep) return true; // power-on: need NTP time and give the user a chance to connect
+  return rtc.raw().wakesSinceWifi >= wifiEveryNWakes;
+}
+
+bool LowPower::record(const Measurement& m, Storage& storage) {
+  if (rtc.push(m)) return true;
+  // full (or ts too far from the base): move everything to flash, then retry
+  if (!flush(storage)) return false;
+  return rtc.push(m);
+}
+
+bool LowPower::flush(Storage& storage) {
+  Measurement batch[16];
+  while (rtc.count() > 0) {
+    uint8_t n = rtc.count() < 16 ? rtc.count() : 16;
+    for (uint8_t i = 0; i < n; i++) batch[i] = rtc.get(i);
+    uint8_t written;
+    bool ok = storage.saveBatch(batch, n, &written);
+    if (written) {
+      if (flushedCallback) flushedCallback(batch, written);
+      rtc.consume(written);
+    }
+    if (!ok) {
+      Serial.println(F("LowPower: failed to flush RTC buffer"));
+      rtc.save();
+      return false;
+    }
+  }
+  rtc.save();
+  return true;
+}
+
+void LowPower::sleep(time_t now, uint32_t seconds) {
+  RtcState& s = rtc.raw();
+  s.sleepEpoch = (uint32_t)now;
+  s.sleepSeconds = seconds;
+  bool radioOnWake = s.wakesSinceWifi + 1 >= wifiEveryNWakes;
+  rtc.save();
+
+  power.deepSleep(seconds, radioOnWake);
+}
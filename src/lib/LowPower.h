@@ -0,0 +1,58 @@
+// lib/LowPower.h
+#pragma once
+#include <Arduino.h>
+#include "PowerControl.h"
+#include "RtcBuffer.h"
+#include "Storage.h"
+
+// Low-power mode is only worth it for long intervals (WiFi association alone takes seconds)
+#define LOWPOWER_MIN_INTERVAL_SECONDS 300
+// Bring WiFi + webserver up about once per period (every period/interval wake-ups, at least every one)
+#define LOWPOWER_WIFI_PERIOD_S 3600UL
+// How long WiFi + webserver stay up on such a wake-up
+#define LOWPOWER_WIFI_WINDOW_MS 60000UL
+
+// Duty-cycled logging: measure, buffer in RTC memory, deep sleep until the next sample.
+// Flash is only written when the RTC buffer is full (or while WiFi is up).
+// The RtcBuffer is shared with the Journal, so both always see the same RTC image.
+class LowPower {
+public:
+  LowPower(PowerControl& power, RtcBuffer& rtc);
+
+  // Restore state after a wake-up; returns true if the device resumed from deep sleep
+  bool begin();
+  bool resumed() const { return resumedFromSleep; }
+
+  // Estimated wall clock after a wake-up (sleep start + sleep duration + time awake)
+  time_t estimatedEpoch() const;
+
+  // Measurement interval; sets how many wake-ups lie between two WiFi windows
+  void setInterval(uint32_t seconds);
+  uint16_t wakesPerWifi() const { return wifiEveryNWakes; }
+
+  // true if this wake-up should bring up WiFi (first boot, scheduled window)
+  bool wifiDue() const;
+  void wifiDone() { rtc.raw().wakesSinceWifi = 0; }
+
+  // Buffer a measurement; flushes the RTC buffer to storage first if it is full
+  bool record(const Measurement& m, Storage& storage);
+
+  // Write all buffered records to storage
+  bool flush(Storage& storage);
+
+  uint16_t buffered() const { return rtc.count(); }
+
+  // Called with every batch that went from RTC memory to flash
+  void setFlushedCallback(void (*cb)(const Measurement* arr, uint8_t len)) { flushedCallback = cb; }
+
+  // Save state and deep sleep for the given time (does not return on the ESP).
+  // now is stored so the clock can be estimated after the wake-up
+  void sleep(time_t now, uint32_t seconds);
+
+private:
+  PowerControl& power;
+  RtcBuffer& rtc;
+  bool resumedFromSleep = false;
+  uint16_t wifiEveryNWakes = LOWPOWER_WIFI_PERIOD_S / LOWPOWER_MIN_INTERVAL_SECONDS;
+  void (*flushedCallback)(const Measurement* arr, uint8_t len) = nullptr;
+};
@@ -0,0 +1,22 @@
+// lib/PowerControl.cpp
+#include "PowerControl.h"
+#include <ESP8266WiFi.h>
+
+bool EspPowerControl::readRtc(uint32_t offsetBlocks, void* data, size_t len) {
+  return ESP.rtcUserMemoryRead(offsetBlocks, (uint32_t*)data, len);
+}
+
+bool EspPowerControl::writeRtc(uint32_t offsetBlocks, const void* data, size_t len) {
+  return ESP.rtcUserMemoryWrite(offsetBlocks, (uint32_t*)data, len);
+}
+
+bool EspPowerControl::wokeFromDeepSleep() {
+  return ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE;
+}
+
+void EspPowerControl::deepSleep(uint32_t seconds, bool radioOnWake) {
+  Serial.printf("PowerControl: deep sleep for %lu s (radio %s)\n", (unsigned long)seconds, radioOnWake ? "on" : "off");
+  Serial.flush();
+  WiFi.disconnect(true);
+  ESP.deepSleep((uint64_t)seconds * 1000000ULL, radioOnWake ? RF_DEFAULT : RF_DISABLED);
+}
@@ -0,0 +1,33 @@
+// lib/PowerControl.h
+#pragma once
+#include <Arduino.h>
+
+// Hardware side of the low-power mode (RTC user memory + deep sleep).
+// LowPower only talks to this interface, so the sleep/wake cycle can be
+// simulated on the host by an implementation that keeps "RTC memory" in
+// a plain array and returns from deepSleep() instead of resetting.
+class PowerControl {
+public:
+  virtual ~PowerControl() {}
+
+  // RTC user memory (512 bytes, survives deep sleep and soft resets, not power loss).
+  // offsetBlocks counts 4-byte blocks, len must be a multiple of 4
+  virtual bool readRtc(uint32_t offsetBlocks, void* data, size_t len) = 0;
+  virtual bool writeRtc(uint32_t offsetBlocks, const void* data, size_t len) = 0;
+
+  // true if this boot is a wake-up from deep sleep (not power-on / reset button)
+  virtual bool wokeFromDeepSleep() = 0;
+
+  // Enter deep sleep; on the ESP8266 this does not return (wake = reset via GPIO16->RST).
+  // radioOnWake=false keeps the radio off after the wake-up (it cannot be enabled before the next sleep)
+  virtual void deepSleep(uint32_t seconds, bool radioOnWake) = 0;
+};
+
+// ESP8266 implementation (needs GPIO16 (D0) wired to RST for the timer wake-up)
+class EspPowerControl : public PowerControl {
+public:
+  bool readRtc(uint32_t offsetBlocks, void* data, size_t len) override;
+  bool writeRtc(uint32_t offsetBlocks, const void* data, size_t len) override;
+  bool wokeFromDeepSleep() override;
+  void deepSleep(uint32_t seconds, bool radioOnWake) override;
+};
@@ -0,0 +1,113 @@
+// lib/RecordFormat.cpp
+#include "RecordFormat.h"
+
+// Write v in decimal, returns number of chars
+static size_t writeUint(char *out, uint32_t v) {
+  char tmp[10];
+  size_t n = 0;
+  do {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  for (size_t i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+  return n;
+}
+
+// Write v with c.decimals decimals, e.g. -12.34 -> "-12.3" for one decimal
+static size_t writeFixed(char *out, float v, const Channel &c) {
+  if (v > c.max) v = c.max;
+  if (v < c.min) v = c.min;
+  const uint32_t scale = record_schema::pow10(c.decimals);
+  // v = mant * 2^-shift exactly, so mant * scale is the exact scaled value in fixed point.
+  // Rounding it is integer only and matches printf except for exact ties
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  const int exp = (int)((bits >> 23) & 0xFF);
+  const int shift = 150 - exp;
+  uint32_t scaled = 0;
+  if (exp != 0 && shift > 0 && shift < 64) { // 0, denormals and NaN write 0
+    uint64_t fixed = (uint64_t)((bits & 0x7FFFFF) | 0x800000) * scale;
+    scaled = (uint32_t)((fixed + (1ULL << (shift - 1))) >> shift);
+  }
+  size_t n = 0;
+  if ((bits >> 31) && scaled) out[n++] = '-';
+  n += writeUint(out + n, scaled / scale);
+  if (c.decimals) {
+    out[n++] = '.';
+    uint32_t frac = scaled % scale;
+    for (uint8_t d = c.decimals; d > 0; d--) {
+      out[n + d - 1] = (char)('0' + frac % 10);
+      frac /= 10;
+    }
+    n += c.decimals;
+  }
+  return n;
+}
+
+size_t formatRecord(char *out, const Measurement &m) {
+  size_t n = writeUint(out, m.ts);
+  for (const Channel &c : RECORD_CHANNELS) {
+    out[n++] = RECORD_SEPARATOR;
+    n += writeFixed(out + n, m.*c.field, c);
+  }
+  out[n++] = '\n';
+  return n;
+}
+
+bool parseRecord(const char *line, Measurement &m) {
+  char *end;
+  unsigned long ts = strtoul(line, &end, 10);
+  if (end == line || ts == 0) return false;
+
+  for (const Channel &c : RECORD_CHANNELS) {
+    if (*end != RECORD_SEPARATOR) return false;
+    const char *p = end + 1;
+    float v = strtof(p, &end);
+    if (end == p || isnan(v)) return false;
+    m.*c.field = v;
+  }
+  if (*end == '\r') end++;
+  if (*end != 0) return false;
+
+  m.ts = (uint32_t)ts;
+  return true;
+}
+
+size_t formatBatch(char *out, size_t cap, const Measurement *arr, size_t len, size_t *written) {
+  size_t pos = 0;
+  size_t i = 0;
+  for (; i < len; i++) {
+    if (cap - pos < RECORD_MAX_LEN) break;
+    pos += formatRecord(out + pos, arr[i]);
+  }
+  if (written) *written = i;
+  return pos;
+}
+
+#ifdef DATALOGGER_BENCH
+void benchRecordFormat() {
+  const int N = 500;
+  char line[32];
+  Measurement m = { 1735689600UL, -12.34f, 56.78f };
+  volatile size_t sink = 0;
+
+  uint32_t start = micros();
+  for (int i = 0; i < N; i++) {
+    m.temp += 0.1f;
+    sink += snprintf(line, sizeof(line), "%lu;%.1f;%.1f\n", (unsigned long)m.ts, m.temp, m.hum);
+  }
+  uint32_t printfUs = micros() - start;
+
+  m.temp = -12.34f;
+  start = micros();
+  for (int i = 0; i < N; i++) {
+    m.temp += 0.1f;
+    sink += formatRecord(line, m);
+  }
+  uint32_t fixedUs = micros() - start;
+
+  Serial.printf("Bench: snprintf %.2f us/record, formatRecord %.2f us/record (%u records)\n",
+                (float)printfUs / N, (float)fixedUs / N, N);
+  (void)sink;
+}
+#endif
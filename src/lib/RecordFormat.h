@@ -0,0 +1,25 @@
+// lib/RecordFormat.h
+#pragma once
+#include <Arduino.h>
+#include "Storage.h"
+#include "RecordSchema.h"
+
+// Render one measurement as "ts;<channels>\n" as described by RECORD_CHANNELS (values
+// clamped to the channel range, rounded half away from zero). The float is decoded into
+// fixed point, so scaling, rounding and digits are integer arithmetic only (no soft-float
+// printf or multiply). Writes no terminating NUL.
+// out needs RECORD_MAX_LEN bytes; returns the number of bytes written
+size_t formatRecord(char *out, const Measurement &m);
+
+// Render len records back to back into out (capacity cap). Stops before a record that
+// would not fit; returns the number of bytes written, *written = records rendered
+size_t formatBatch(char *out, size_t cap, const Measurement *arr, size_t len, size_t *written = nullptr);
+
+// Parse one record line (without '\n', NUL-terminated, trailing '\r' allowed) into m.
+// Returns false on malformed lines or NaN values
+bool parseRecord(const char *line, Measurement &m);
+
+#ifdef DATALOGGER_BENCH
+// Prints the per-record cost of snprintf("%.1f") vs. formatRecord() to Serial
+void benchRecordFormat();
+#endif
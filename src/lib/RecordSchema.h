@@ -0,0 +1,71 @@
+// lib/RecordSchema.h
+#pragma once
+#include <Arduino.h>
+#include "Storage.h"
+
+// Compile-time description of a logged record: "ts;<channel>;<channel>...\n".
+// Derived from RECORD_CHANNELS: the CSV formatter and import parser, the size estimates,
+// the sensor driver's NaN check, /api/latestMeasurement, /api/summary and /api/schema
+// (the web UI renders its columns from the latter).
+// Not derived: the fields of Measurement, the packed journal records (RtcRecord and
+// JournalEntry, static_asserts catch a mismatch), the dew point in Summary and the parser
+// of tools/collector. A variant with other channels has to change those as well.
+
+#define RECORD_SEPARATOR ';'
+
+// One measured value of a record
+struct Channel {
+  const char* name;           // CSV column / JSON key
+  const char* label;          // name in the web UI
+  const char* unit;
+  float Measurement::* field; // where the value lives in Measurement
+  uint8_t decimals;
+  float min;                  // values are clamped to [min, max] when written
+  float max;
+  uint8_t typicalChars;       // usual rendered width, for storage estimates
+};
+
+static constexpr Channel RECORD_CHANNELS[] = {
+  // temp: clamped so temp*10 fits into int16 (see RtcRecord)
+  { "temp", "Temperature", "°C",         &Measurement::temp, 1, -3276.8f, 3276.7f, 4 },  // "21.5"
+  { "hum",  "Humidity",    "%",            &Measurement::hum,  1, 0.0f,     100.0f,  4 },  // "48.2"
+};
+
+static constexpr size_t RECORD_CHANNEL_COUNT = sizeof(RECORD_CHANNELS) / sizeof(RECORD_CHANNELS[0]);
+
+namespace record_schema {
+
+constexpr uint8_t digits(uint32_t v) {
+  return v < 10 ? 1 : 1 + digits(v / 10);
+}
+
+constexpr uint32_t pow10(uint8_t n) {
+  return n == 0 ? 1 : 10 * pow10(n - 1);
+}
+
+constexpr float absMax(const Channel& c) {
+  return (c.min < 0 ? -c.min : c.min) > c.max ? (c.min < 0 ? -c.min : c.min) : c.max;
+}
+
+// Widest rendered value of a channel (sign + integer digits + decimals)
+constexpr uint8_t maxChars(const Channel& c) {
+  return (c.min < 0 ? 1 : 0) + digits((uint32_t)absMax(c)) + (c.decimals ? 1 + c.decimals : 0);
+}
+
+constexpr size_t channelsLen(size_t i, bool typical) {
+  return i == RECORD_CHANNEL_COUNT
+           ? 0
+           : 1 + (typical ? RECORD_CHANNELS[i].typicalChars : maxChars(RECORD_CHANNELS[i])) +
+               channelsLen(i + 1, typical);
+}
+
+} // namespace record_schema
+
+// Timestamp column: epoch seconds, at most 10 digits
+static constexpr size_t RECORD_TS_MAX_CHARS = 10;
+
+// Longest record incl. '\n' (buffers for formatRecord need this much)
+static constexpr size_t RECORD_MAX_LEN = RECORD_TS_MAX_CHARS + record_schema::channelsLen(0, false) + 1;
+
+// Usual record length, used for "weeks left" style estimates
+static constexpr size_t RECORD_TYPICAL_LEN = RECORD_TS_MAX_CHARS + record_schema::channelsLen(0, true) + 1;
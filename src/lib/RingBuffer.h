@@ -0,0 +1,56 @@
+// lib/RingBuffer.h
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// The producer (loop() or a sampling ISR) only writes head, the consumer (flush)
+// only writes tail, so neither side ever waits for the other. When full, push()
+// fails and the sample is counted as overflow instead of overwriting anything.
+template <typename T, uint32_t N>
+class RingBuffer {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of 2");
+
+public:
+  // Producer side
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N) {
+      overflowCount.store(overflowCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: oldest entries as one contiguous block (up to the wrap-around).
+  // Returns the number of entries available at *first
+  uint32_t peek(const T*& first) const {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t avail = head.load(std::memory_order_acquire) - t;
+    uint32_t toEnd = N - (t & (N - 1));
+    first = &items[t & (N - 1)];
+    return avail < toEnd ? avail : toEnd;
+  }
+
+  // Consumer side: release n entries after they were stored
+  void pop(uint32_t n) {
+    tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  uint32_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr uint32_t capacity() { return N; }
+
+  // Samples rejected because the buffer was full
+  uint32_t overflows() const { return overflowCount.load(std::memory_order_relaxed); }
+
+private:
+  T items[N];
+  std::atomic<uint32_t> head{0}; // free-running, written by the producer only
+  std::atomic<uint32_t> tail{0}; // free-running, written by the consumer only
+  std::atomic<uint32_t> overflowCount{0};
+};
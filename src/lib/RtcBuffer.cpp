@@ -0,0 +1,97 @@
+// lib/RtcBuffer.cpp
+#include "RtcBuffer.h"
+#include "RecordSchema.h"
+
+// RtcRecord packs exactly these two channels with one decimal
+static_assert(RECORD_CHANNEL_COUNT == 2 &&
+              RECORD_CHANNELS[0].field == &Measurement::temp && RECORD_CHANNELS[0].decimals == 1 &&
+              RECORD_CHANNELS[1].field == &Measurement::hum && RECORD_CHANNELS[1].decimals == 1,
+              "RtcRecord does not match the record schema");
+
+#define RTC_STATE_MAGIC 0x44524231UL // "DRB1"
+// User memory block 0; the core only uses RTC user memory for OTA (eboot), which this project does not use
+#define RTC_STATE_OFFSET 0
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+RtcBuffer::RtcBuffer(PowerControl& p) : power(p) {
+  clear();
+}
+
+uint32_t RtcBuffer::computeCrc() const {
+  const uint8_t* start = (const uint8_t*)&state.baseTs;
+  // only the used part of the record array is covered
+  size_t len = offsetof(RtcState, records) - offsetof(RtcState, baseTs) + state.count * sizeof(RtcRecord);
+  return crc32Update(0, start, len);
+}
+
+bool RtcBuffer::load() {
+  if (!power.readRtc(RTC_STATE_OFFSET, &state, sizeof(state))) {
+    clear();
+    return false;
+  }
+  if (state.magic != RTC_STATE_MAGIC || state.count > RTC_BUFFER_CAPACITY || state.crc != computeCrc()) {
+    Serial.println(F("RtcBuffer: no valid state in RTC memory"));
+    clear();
+    return false;
+  }
+  Serial.printf("RtcBuffer: restored %u records\n", state.count);
+  return true;
+}
+
+void RtcBuffer::save() {
+  state.magic = RTC_STATE_MAGIC;
+  state.crc = computeCrc();
+  power.writeRtc(RTC_STATE_OFFSET, &state, sizeof(state));
+}
+
+bool RtcBuffer::push(const Measurement& m) {
+  if (isFull()) return false;
+  if (state.count == 0) state.baseTs = m.ts;
+  if (m.ts < state.baseTs || m.ts - state.baseTs > 0xFFFFUL) return false;
+
+  RtcRecord& r = state.records[state.count];
+  r.dts = (uint16_t)(m.ts - state.baseTs);
+  r.temp10 = (int16_t)lroundf(m.temp * 10.0f);
+  r.hum10 = (uint16_t)lroundf(m.hum * 10.0f);
+  state.count++;
+  return true;
+}
+
+Measurement RtcBuffer::get(uint16_t index) const {
+  const RtcRecord& r = state.records[index];
+  Measurement m;
+  m.ts = state.baseTs + r.dts;
+  m.temp = r.temp10 / 10.0f;
+  m.hum = r.hum10 / 10.0f;
+  return m;
+}
+
+void RtcBuffer::consume(uint16_t n) {
+  if (n >= state.count) {
+    state.count = 0;
+    return;
+  }
+  // rebase the remaining records on the new first one
+  uint32_t newBase = state.baseTs + state.records[n].dts;
+  for (uint16_t i = n; i < state.count; i++) {
+    RtcRecord r = state.records[i];
+    r.dts = (uint16_t)(state.baseTs + r.dts - newBase);
+    state.records[i - n] = r;
+  }
+  state.baseTs = newBase;
+  state.count -= n;
+}
+
+void RtcBuffer::clear() {
+  memset(&state, 0, sizeof(state));
+}
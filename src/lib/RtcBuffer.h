@@ -0,0 +1,61 @@
+// lib/RtcBuffer.h
+#pragma once
+#include <Arduino.h>
+#include "PowerControl.h"
+#include "Storage.h"
+
+// Compact sample as kept in RTC memory (6 bytes instead of 12 for Measurement)
+struct RtcRecord {
+  uint16_t dts;    // seconds since RtcState::baseTs
+  int16_t temp10;  // temperature * 10
+  uint16_t hum10;  // humidity * 10
+};
+
+#define RTC_BUFFER_CAPACITY 80
+
+// Whole RTC user memory image (must fit into 512 bytes, multiple of 4)
+struct RtcState {
+  uint32_t magic;
+  uint32_t crc;          // over everything after this field
+  uint32_t baseTs;       // timestamp of the first buffered record
+  uint32_t sleepEpoch;   // estimated epoch when the device went to sleep
+  uint32_t sleepSeconds; // requested sleep duration
+  uint16_t count;        // buffered records
+  uint16_t wakesSinceWifi;
+  RtcRecord records[RTC_BUFFER_CAPACITY];
+};
+
+static_assert(sizeof(RtcState) <= 512, "RtcState exceeds RTC user memory");
+static_assert(sizeof(RtcState) % 4 == 0, "RtcState must be a multiple of 4 bytes");
+
+// Measurement buffer that lives in RTC user memory and survives deep sleep
+class RtcBuffer {
+public:
+  explicit RtcBuffer(PowerControl& power);
+
+  // Read state from RTC memory; returns false (and starts empty) if there was no valid state
+  bool load();
+
+  // Write state back to RTC memory (call before sleeping / after changes)
+  void save();
+
+  // Append a record; false if full or ts is not representable relative to baseTs
+  bool push(const Measurement& m);
+
+  uint16_t count() const { return state.count; }
+  bool isFull() const { return state.count >= RTC_BUFFER_CAPACITY; }
+  Measurement get(uint16_t index) const;
+
+  // Drop the first n records (after they were written to flash)
+  void consume(uint16_t n);
+  void clear();
+
+  RtcState& raw() { return state; }
+  const RtcState& raw() const { return state; }
+
+private:
+  PowerControl& power;
+  RtcState state;
+
+  uint32_t computeCrc() const;
+};
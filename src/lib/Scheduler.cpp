@@ -0,0 +1,87 @@
+// lib/Scheduler.cpp
+#include "Scheduler.h"
+#include <sys/time.h>
+
+// Wall clock below this is not NTP backed yet (2021-01-01, same limit as Utils::getEpoch)
+#define SCHEDULER_MIN_VALID_EPOCH 1609459200UL
+// Lateness beyond this many intervals is treated as a clock step, not as missed samples
+#define SCHEDULER_RESYNC_SLOTS 3
+
+Scheduler::Scheduler() : interval(300), nextSlot(0) {
+  resetStats();
+}
+
+void Scheduler::setInterval(uint32_t intervalSeconds) {
+  interval = intervalSeconds > 0 ? intervalSeconds : 1;
+  nextSlot = 0; // re-anchor on the next poll
+}
+
+void Scheduler::anchor(uint32_t nowSeconds) {
+  nextSlot = (nowSeconds / interval + 1) * interval;
+}
+
+bool Scheduler::due(uint32_t &scheduledTs) {
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  if ((uint32_t)tv.tv_sec < SCHEDULER_MIN_VALID_EPOCH) return false;
+
+  uint32_t nowSeconds = (uint32_t)tv.tv_sec;
+  if (nextSlot == 0) {
+    anchor(nowSeconds);
+    Serial.printf("Scheduler: first sample at %lu\n", (unsigned long)nextSlot);
+    return false;
+  }
+
+  int64_t nowMs = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  int64_t lateMs = nowMs - (int64_t)nextSlot * 1000;
+  int64_t intervalMs = (int64_t)interval * 1000;
+
+  if (lateMs < 0) {
+    // Clock stepped back by more than an interval (e.g. NTP correction): re-anchor
+    if (-lateMs > intervalMs) {
+      anchor(nowSeconds);
+      jitter.resyncs++;
+    }
+    return false;
+  }
+
+  if (lateMs >= intervalMs) {
+    int64_t slots = lateMs / intervalMs;
+    if (slots > SCHEDULER_RESYNC_SLOTS) {
+      // Clock stepped forward: continue at the next boundary, nothing was really missed
+      anchor(nowSeconds);
+      jitter.resyncs++;
+      return false;
+    }
+    // Loop was blocked: skip the slots that are over, take the current one
+    jitter.missed += (uint32_t)slots;
+    nextSlot += (uint32_t)slots * interval;
+    lateMs -= slots * intervalMs;
+  }
+
+  scheduledTs = nextSlot;
+  nextSlot += interval;
+
+  int32_t late = (int32_t)lateMs;
+  if (jitter.samples == 0 || late < jitter.minLateMs) jitter.minLateMs = late;
+  if (jitter.samples == 0 || late > jitter.maxLateMs) jitter.maxLateMs = late;
+  jitter.sumLateMs += late;
+  jitter.samples++;
+  return true;
+}
+
+uint32_t Scheduler::nearestSlot(time_t t) const {
+  uint32_t s = (uint32_t)t;
+  return ((s + interval / 2) / interval) * interval;
+}
+
+uint32_t Scheduler::secondsUntilNext(time_t t, uint32_t minSeconds) const {
+  uint32_t s = (uint32_t)t;
+  uint32_t seconds = interval - (s % interval);
+  while (seconds < minSeconds) seconds += interval;
+  return seconds;
+}
+
+void Scheduler::resetStats() {
+  memset(&jitter, 0, sizeof(jitter));
+}
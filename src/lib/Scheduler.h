@@ -0,0 +1,45 @@
+// lib/Scheduler.h
+#pragma once
+#include <Arduino.h>
+
+// Timing quality of the sampling clock (lateness = actual start - scheduled time)
+struct JitterStats {
+  uint32_t samples;  // samples taken
+  uint32_t missed;   // slots skipped because the loop was blocked for more than an interval
+  uint32_t resyncs;  // re-anchoring after the wall clock was stepped (NTP sync / correction)
+  int32_t minLateMs;
+  int32_t maxLateMs;
+  int64_t sumLateMs;
+};
+
+// Sampling clock anchored to absolute wall-clock boundaries (every :00/:05 for a 5 min
+// interval). Each due sample carries its scheduled timestamp, so a blocked loop or slow
+// sensor read never accumulates drift and samples from several loggers line up exactly.
+class Scheduler {
+public:
+  Scheduler();
+
+  // (Re)start with a new interval; the first sample is the next boundary
+  void setInterval(uint32_t intervalSeconds);
+  uint32_t getInterval() const { return interval; }
+
+  // Poll from loop(). Returns true once per slot and sets scheduledTs to the slot time.
+  // Never fires before the wall clock is valid (NTP synced or restored)
+  bool due(uint32_t &scheduledTs);
+
+  // Slot boundary closest to t (for samples taken right after a timed wake-up)
+  uint32_t nearestSlot(time_t t) const;
+
+  // Seconds from t until the next slot boundary (at least minSeconds)
+  uint32_t secondsUntilNext(time_t t, uint32_t minSeconds = 1) const;
+
+  const JitterStats& stats() const { return jitter; }
+  void resetStats();
+
+private:
+  uint32_t interval;
+  uint32_t nextSlot; // epoch of the next sample, 0 = not anchored yet
+  JitterStats jitter;
+
+  void anchor(uint32_t nowSeconds);
+};
@@ -1,5 +1,8 @@
 // lib/Sensor.cpp
 #include "Sensor.h"
+#include "RecordSchema.h"
+
+#if SENSOR_DRIVER == SENSOR_DRIVER_DHT
 #include <DHT.h>
 
 // Pin und Typ anpassen falls nötig
@@ -12,21 +15,41 @@
 
 static DHT dht(DHTPIN, DHTTYPE);
 
+static void driverBegin() {
+  dht.begin();
+}
+
+static void driverRead(Measurement& m) {
+  // Non-blocking note: DHT library uses delays internally; keep interval large enough
+  m.temp = dht.readTemperature();
+  m.hum = dht.readHumidity();
+}
+
+#elif SENSOR_DRIVER == SENSOR_DRIVER_SIM
+
+static void driverBegin() { }
+
+// Slow daily-like curves (period ~24 min of uptime), enough to exercise logging and UI
+static void driverRead(Measurement& m) {
+  float phase = (float)(millis() % 1440000UL) / 1440000.0f * 2.0f * (float)PI;
+  m.temp = 21.0f + 4.0f * sinf(phase);
+  m.hum = 50.0f - 15.0f * sinf(phase);
+}
+
+#else
+  #error "Unknown SENSOR_DRIVER"
+#endif
+
 Sensor::Sensor() { }
 
 void Sensor::begin() {
-  dht.begin();
+  driverBegin();
 }
 
-bool Sensor::read(float& temperature, float& humidity) {
-  // Non-blocking note: DHT library uses delays internally; keep interval large enough
-  float t = dht.readTemperature();
-  float h = dht.readHumidity();
-  if (!isnan(t) && !isnan(h)) {
-    temperature = t;
-    humidity = h;
-    return true;
+bool Sensor::read(Measurement& m) {
+  driverRead(m);
+  for (const Channel& c : RECORD_CHANNELS) {
+    if (isnan(m.*c.field)) return false;
   }
-
-  return false;
+  return true;
 }
@@ -1,11 +1,22 @@
 // lib/Sensor.h
 #pragma once
 #include <Arduino.h>
+#include "Storage.h"
+
+// Sensor driver, chosen at build time (build_flags = -DSENSOR_DRIVER=...). Each driver has
+// its own environment in platformio.ini that also lists its library, e.g. nodemcuv2 (DHT)
+// and nodemcuv2_sim; only the selected driver and its library are built
+#define SENSOR_DRIVER_DHT 1   // DHT11/DHT22 (DHTPIN, DHTTYPE)
+#define SENSOR_DRIVER_SIM 2   // synthetic values, for boards without a sensor
+#ifndef SENSOR_DRIVER
+  #define SENSOR_DRIVER SENSOR_DRIVER_DHT
+#endif
 
 class Sensor {
 public:
   Sensor();
   void begin();
-  // returns true if values valid (and filled), false otherwise
-  bool read(float& temperature, float& humidity);
+  // Fills the channel values of m (see RECORD_CHANNELS, ts is left alone).
+  // returns true if all values are valid, false otherwise
+  bool read(Measurement& m);
 };
@@ -1,7 +1,9 @@
 #include "Storage.h"
+#include "RecordFormat.h"
 #include <LittleFS.h>
 #include <FS.h>
 #include <ArduinoJson.h>
+#include <new>
 
 Storage::Storage() {}
 
@@ -12,8 +14,6 @@ void Storage::begin() {
   } else {
     Serial.println(F("Storage: LittleFS ready"));
   }
-
-    debugListFiles();
 }
 
 FsUsage Storage::getFsUsage() {
@@ -22,66 +22,88 @@ FsUsage Storage::getFsUsage() {
   return { info.usedBytes, info.totalBytes };
 }
 
-bool Storage::loadSettings(uint32_t &intervalSeconds, String &ssid, String &pass, String &httpPassword) {
-  if (!LittleFS.exists("/settings.json")) {
-    Serial.println(F("Storage: settings.json does not exist"));
-    return false;
+static const char SETTINGS_PATH[]        = "/settings.json";
+static const char SETTINGS_TMP_PATH[]    = "/settings.json.tmp";
+static const char SETTINGS_LEGACY_PATH[] = "/config/settings.json";
+
+bool Storage::loadSettings(Settings &settings) {
+  const char *path = SETTINGS_PATH;
+  if (!LittleFS.exists(path)) {
+    // Older firmware wrote the web UI settings to /config/settings.json
+    path = SETTINGS_LEGACY_PATH;
+    if (!LittleFS.exists(path)) {
+      Serial.println(F("Storage: settings.json does not exist"));
+      return false;
+    }
   }
 
-  File f = LittleFS.open("/settings.json", "r");
+  File f = LittleFS.open(path, "r");
   if (!f) {
-    Serial.println(F("Storage: failed to open settings.json"));
+    Serial.printf("Storage: failed to open %s\n", path);
     return false;
   }
 
-  size_t size = f.size();
-  std::unique_ptr<char[]> buf(new char[size + 1]);
-  f.readBytes(buf.get(), size);
-  buf[size] = 0;
-  f.close();
-
   DynamicJsonDocument doc(512);
-  auto err = deserializeJson(doc, buf.get());
+  auto err = deserializeJson(doc, f);
+  f.close();
   if (err) {
-    Serial.println(F("Storage: settings.json parse error"));
+    Serial.printf("Storage: %s parse error\n", path);
     return false;
   }
   if (doc["interval"].is<uint32_t>())
-    intervalSeconds = doc["interval"].as<uint32_t>();
+    settings.intervalSeconds = doc["interval"].as<uint32_t>();
   if (doc["wifi_ssid"].is<const char*>())
-    ssid = doc["wifi_ssid"].as<const char*>();
+    settings.wifiSsid = doc["wifi_ssid"].as<const char*>();
   if (doc["wifi_pass"].is<const char*>())
-    pass = doc["wifi_pass"].as<const char*>();
+    settings.wifiPass = doc["wifi_pass"].as<const char*>();
   if (doc["http_password"].is<const char*>())
-    httpPassword = doc["http_password"].as<const char*>();
+    settings.httpPassword = doc["http_password"].as<const char*>();
+  if (doc["low_power"].is<bool>())
+    settings.lowPower = doc["low_power"].as<bool>();
+
+  Serial.printf("Storage: Settings loaded from %s\n", path);
 
-  Serial.println(F("Storage: Settings loaded from settings.json"));
+  // Migrate legacy file so there is only one settings file from now on
+  if (path == SETTINGS_LEGACY_PATH && saveSettings(settings)) {
+    LittleFS.remove(SETTINGS_LEGACY_PATH);
+  }
   return true;
 }
 
-bool Storage::saveSettings(uint32_t intervalSeconds, const String &ssid, const String &pass, const String &httpPassword) {
+bool Storage::saveSettings(const Settings &settings) {
 
   DynamicJsonDocument doc(512);
 
   // exakt dieselben Keys wie loadSettings()
-  doc["interval"] = intervalSeconds;
-  doc["wifi_ssid"] = ssid;
-  doc["wifi_pass"] = pass;
-  doc["http_password"] = httpPassword;
+  doc["interval"] = settings.intervalSeconds;
+  doc["wifi_ssid"] = settings.wifiSsid;
+  doc["wifi_pass"] = settings.wifiPass;
+  doc["http_password"] = settings.httpPassword;
+  doc["low_power"] = settings.lowPower;
 
-  File f = LittleFS.open("/settings.json", "w");
+  // Write to a temp file first, then rename over the old one:
+  // a reset during the write leaves the previous settings intact
+  File f = LittleFS.open(SETTINGS_TMP_PATH, "w");
   if (!f) {
-    Serial.println(F("Storage: failed to open settings.json for writing"));
+    Serial.println(F("Storage: failed to open settings.json.tmp for writing"));
     return false;
   }
 
   if (serializeJson(doc, f) == 0) {
-    Serial.println(F("Storage: failed to write settings.json"));
+    Serial.println(F("Storage: failed to write settings.json.tmp"));
     f.close();
+    LittleFS.remove(SETTINGS_TMP_PATH);
     return false;
   }
-
   f.close();
+
+  // LittleFS rename replaces an existing target atomically
+  if (!LittleFS.rename(SETTINGS_TMP_PATH, SETTINGS_PATH)) {
+    Serial.println(F("Storage: failed to rename settings.json.tmp"));
+    LittleFS.remove(SETTINGS_TMP_PATH);
+    return false;
+  }
+
   Serial.println(F("Storage: settings.json saved"));
 
   return true;
@@ -98,11 +120,47 @@ static String weekNameFromTime(time_t t) {
   return String(buf);
 }
 
-bool Storage::saveBatch(Measurement *arr, uint8_t len) {
+// Same partitioning as weekNameFromTime, as a number (cheap to compare per record)
+static uint32_t weekKeyFromTime(time_t t) {
+  tm tmstruct;
+  gmtime_r(&t, &tmstruct);
+  return (uint32_t)(tmstruct.tm_year + 1900) * 100 + (tmstruct.tm_yday / 7) + 1;
+}
+
+uint32_t Storage::weekKey(time_t t) {
+  return weekKeyFromTime(t);
+}
+
+uint32_t Storage::lastTimestampInWeek(time_t t) {
+  File f = LittleFS.open("/" + weekNameFromTime(t) + ".csv", "r");
+  if (!f) return 0;
+  // records are written by formatRecord, so the last complete line is in this tail
+  char tail[2 * RECORD_MAX_LEN + 1];
+  size_t size = f.size();
+  size_t from = size > sizeof(tail) - 1 ? size - (sizeof(tail) - 1) : 0;
+  size_t n = f.seek(from) ? f.read((uint8_t *)tail, size - from) : 0;
+  f.close();
+
+  while (n > 0 && (tail[n - 1] == '\n' || tail[n - 1] == '\r')) n--;
+  tail[n] = 0;
+  size_t start = n;
+  while (start > 0 && tail[start - 1] != '\n') start--;
+  if (start == 0 && from > 0) return 0; // no complete line in the tail (not our format)
+  return (uint32_t)strtoul(tail + start, nullptr, 10);
+}
+
+bool Storage::saveBatch(const Measurement *arr, uint8_t len, uint8_t *written, bool reclaim) {
+  if (written) *written = 0;
   if (len == 0) return true;
 
-  // Estimate bytes needed: roughly len * 40 (timestamp;temp;hum\n)
-  uint32_t estimated = (uint32_t)len * 40;
+  // Render the whole batch first, so the exact size is known and it goes out in one write
+  std::unique_ptr<char[]> buf(new (std::nothrow) char[(size_t)len * RECORD_MAX_LEN]);
+  if (!buf) {
+    Serial.println(F("Storage: out of memory for batch"));
+    return false;
+  }
+  size_t bytes = formatBatch(buf.get(), (size_t)len * RECORD_MAX_LEN, arr, len);
+  uint32_t estimated = (uint32_t)bytes;
 
   // Check 85%-rule
   FsUsage fs = getFsUsage();
@@ -113,6 +171,10 @@ bool Storage::saveBatch(Measurement *arr, uint8_t len) {
 
   // while writing would exceed threshold, delete oldest file(s)
   while ((used + estimated) > threshold) {
+    if (!reclaim) {
+      Serial.println(F("Storage: full, not deleting old weeks for this batch"));
+      return false;
+    }
     bool deleted = deleteOldestWeek();
     if (!deleted) {
       Serial.println(F("Storage: cannot free more space"));
@@ -122,24 +184,43 @@ bool Storage::saveBatch(Measurement *arr, uint8_t len) {
     used = fs.used;
   }
 
-  // Determine current week file name (use time of first measurement)
-  String week = weekNameFromTime((time_t)arr[0].ts);
-  String path = "/" + week + ".csv";
+  // Route every record into the file of its own week (a batch may span a week boundary,
+  // an import many weeks). Each run of the same week is one open + one write
+  const char *p = buf.get();
+  uint8_t i = 0;
+  while (i < len) {
+    uint32_t key = weekKeyFromTime((time_t)arr[i].ts);
+    uint8_t j = i + 1;
+    while (j < len && weekKeyFromTime((time_t)arr[j].ts) == key) j++;
 
-  // Open file for append
-  File f = LittleFS.open(path, "a");
-  if (!f) {
-    Serial.printf("Storage: failed to open %s for append\n", path.c_str());
-    return false;
-  }
+    // byte range of records i..j-1 in the rendered buffer (one '\n' per record)
+    const char *end = p;
+    for (uint8_t k = i; k < j; k++) {
+      end = (const char *)memchr(end, '\n', buf.get() + bytes - end) + 1;
+    }
+    size_t runBytes = end - p;
+
+    String path = "/" + weekNameFromTime((time_t)arr[i].ts) + ".csv";
+
+    // Open file for append
+    File f = LittleFS.open(path, "a");
+    if (!f) {
+      Serial.printf("Storage: failed to open %s for append\n", path.c_str());
+      return false;
+    }
 
-  // Write all entries
-  for (uint8_t i = 0; i < len; i++) {
-    char line[32];
-    snprintf(line, sizeof(line), "%lu;%.1f;%.1f\n", (unsigned long)arr[i].ts, arr[i].temp, arr[i].hum);
-    f.print(line);
+    // Single write for all entries of this week
+    size_t runWritten = f.write((const uint8_t *)p, runBytes);
+    f.close();
+    if (runWritten != runBytes) {
+      Serial.printf("Storage: short write to %s (%u of %u bytes)\n", path.c_str(), (unsigned)runWritten, (unsigned)runBytes);
+      return false;
+    }
+
+    p = end;
+    i = j;
+    if (written) *written = i;
   }
-  f.close();
   return true;
 }
 
@@ -8,6 +8,15 @@ struct Measurement {
   float hum;
 };
 
+// Persistent device settings, held once in RAM and written back atomically
+struct Settings {
+  uint32_t intervalSeconds;
+  String wifiSsid;
+  String wifiPass;
+  String httpPassword;
+  bool lowPower; // deep-sleep duty cycling (only effective for long intervals)
+};
+
 struct FsUsage {
   size_t used;
   size_t total;
@@ -19,14 +28,24 @@ public:
   void begin();
 
   // Save a batch of measurements (array of Measurement of length len)
-  // returns true on success
-  bool saveBatch(Measurement *arr, uint8_t len);
+  // returns true on success. *written = records that reached flash, also on failure: a
+  // batch spanning weeks goes out file by file, so a failure can leave a written prefix.
+  // reclaim = false: never delete old weeks to make room (imports), fail instead
+  bool saveBatch(const Measurement *arr, uint8_t len, uint8_t *written = nullptr, bool reclaim = true);
+
+  // Week file partition of t as a number (year * 100 + week), cheap to compare per record
+  static uint32_t weekKey(time_t t);
+
+  // Timestamp of the last record in the week file that holds t, 0 if there is none.
+  // Reads only the end of the file
+  uint32_t lastTimestampInWeek(time_t t);
 
-  // Load settings from /data/settings.json (if exists). Returns true if loaded
-  bool loadSettings(uint32_t &intervalSeconds, String &ssid, String &pass, String &httpPassword);
+  // Load settings from /settings.json (falls back to legacy /config/settings.json).
+  // Only keys present in the file overwrite the given values. Returns true if loaded
+  bool loadSettings(Settings &settings);
 
-  // Save settings to /data/settings.json
-  bool saveSettings(uint32_t intervalSeconds, const String& ssid, const String& pass, const String& httpPassword);
+  // Save settings to /settings.json (temp file + rename, never leaves a half-written file)
+  bool saveSettings(const Settings &settings);
 
 
   // Storage info
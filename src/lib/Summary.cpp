@@ -0,0 +1,142 @@
+// lib/Summary.cpp
+#include "Summary.h"
+#include <LittleFS.h>
+#include <FS.h>
+
+static const char SUMMARY_PATH[]     = "/summary.bin";
+static const char SUMMARY_TMP_PATH[] = "/summary.bin.tmp";
+#define SUMMARY_MAGIC 0x53554D31UL // "SUM1", bump when PeriodStats changes
+
+struct SummaryCheckpoint {
+  uint32_t magic;
+  uint32_t size;
+  PeriodStats periods[SUMMARY_PERIODS];
+};
+
+void RunningStat::reset() {
+  count = 0;
+  min = 0;
+  max = 0;
+  minTs = 0;
+  maxTs = 0;
+  mean = 0;
+  m2 = 0;
+}
+
+void RunningStat::add(float v, uint32_t ts) {
+  count++;
+  if (count == 1 || v < min) { min = v; minTs = ts; }
+  if (count == 1 || v > max) { max = v; maxTs = ts; }
+  double delta = v - mean;
+  mean += delta / count;
+  m2 += delta * (v - mean);
+}
+
+void PeriodStats::reset(uint32_t periodStart) {
+  start = periodStart;
+  for (RunningStat& rs : channels) rs.reset();
+  dew.reset();
+}
+
+Summary::Summary() {
+  for (uint8_t p = 0; p < SUMMARY_PERIODS; p++) periods[p].reset(0);
+}
+
+const char* Summary::periodName(SummaryPeriod p) {
+  switch (p) {
+    case SUMMARY_HOUR: return "hour";
+    case SUMMARY_DAY:  return "day";
+    case SUMMARY_WEEK: return "week";
+    default:           return "boot";
+  }
+}
+
+float Summary::dewPoint(float temp, float hum) {
+  if (hum <= 0.0f) return NAN;
+  const float b = 17.62f;
+  const float c = 243.12f;
+  float gamma = logf(hum / 100.0f) + b * temp / (c + temp);
+  return c * gamma / (b - gamma);
+}
+
+uint32_t Summary::periodStart(SummaryPeriod p, uint32_t ts) {
+  switch (p) {
+    case SUMMARY_HOUR:
+      return ts - ts % 3600;
+    case SUMMARY_DAY:
+      return ts - ts % 86400;
+    case SUMMARY_WEEK: {
+      // day-of-year/7 like Storage's week files (week 1 starts on Jan 1st)
+      time_t t = (time_t)ts;
+      tm tmstruct;
+      gmtime_r(&t, &tmstruct);
+      return ts - ts % 86400 - (uint32_t)(tmstruct.tm_yday % 7) * 86400;
+    }
+    default:
+      return 0;
+  }
+}
+
+void Summary::add(const Measurement& m) {
+  float dew = dewPoint(m.temp, m.hum);
+
+  for (uint8_t i = 0; i < SUMMARY_PERIODS; i++) {
+    SummaryPeriod p = (SummaryPeriod)i;
+    PeriodStats& ps = periods[p];
+    if (p == SUMMARY_BOOT) {
+      if (ps.start == 0) ps.reset(m.ts);
+    } else {
+      uint32_t start = periodStart(p, m.ts);
+      if (start > ps.start) ps.reset(start);
+      else if (start < ps.start) continue; // older than the running period (clock stepped back)
+    }
+    for (size_t c = 0; c < RECORD_CHANNEL_COUNT; c++) ps.channels[c].add(m.*RECORD_CHANNELS[c].field, m.ts);
+    if (!isnan(dew)) ps.dew.add(dew, m.ts);
+  }
+  dirty = true;
+}
+
+bool Summary::load(bool keepBoot) {
+  File f = LittleFS.open(SUMMARY_PATH, "r");
+  if (!f) return false;
+
+  SummaryCheckpoint cp;
+  size_t n = f.read((uint8_t*)&cp, sizeof(cp));
+  f.close();
+  if (n != sizeof(cp) || cp.magic != SUMMARY_MAGIC || cp.size != sizeof(cp)) {
+    Serial.println(F("Summary: checkpoint invalid, starting empty"));
+    return false;
+  }
+
+  for (uint8_t p = 0; p < SUMMARY_PERIODS; p++) {
+    if (p == SUMMARY_BOOT && !keepBoot) continue;
+    periods[p] = cp.periods[p];
+  }
+  dirty = false;
+  Serial.println(F("Summary: checkpoint restored"));
+  return true;
+}
+
+bool Summary::save() {
+  if (!dirty) return true;
+
+  SummaryCheckpoint cp;
+  cp.magic = SUMMARY_MAGIC;
+  cp.size = sizeof(cp);
+  memcpy(cp.periods, periods, sizeof(periods));
+
+  File f = LittleFS.open(SUMMARY_TMP_PATH, "w");
+  if (!f) {
+    Serial.println(F("Summary: failed to open checkpoint for writing"));
+    return false;
+  }
+  size_t written = f.write((const uint8_t*)&cp, sizeof(cp));
+  f.close();
+  if (written != sizeof(cp) || !LittleFS.rename(SUMMARY_TMP_PATH, SUMMARY_PATH)) {
+    Serial.println(F("Summary: failed to write checkpoint"));
+    LittleFS.remove(SUMMARY_TMP_PATH);
+    return false;
+  }
+  dirty = false;
+  return true;
+}
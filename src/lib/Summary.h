@@ -0,0 +1,67 @@
+// lib/Summary.h
+#pragma once
+#include <Arduino.h>
+#include "Storage.h"
+#include "RecordSchema.h"
+
+// Running statistics of one quantity (Welford: mean/variance without keeping the samples)
+struct RunningStat {
+  uint32_t count;
+  float min;
+  float max;
+  uint32_t minTs;
+  uint32_t maxTs;
+  double mean;
+  double m2;     // sum of squared deviations from the mean
+
+  void reset();
+  void add(float v, uint32_t ts);
+  float variance() const { return count > 1 ? (float)(m2 / (count - 1)) : 0.0f; }
+  float stddev() const { return sqrtf(variance()); }
+};
+
+// Statistics of all samples within one period
+struct PeriodStats {
+  uint32_t start;    // epoch of the period start, 0 = no samples yet
+  RunningStat channels[RECORD_CHANNEL_COUNT]; // in RECORD_CHANNELS order
+  RunningStat dew;   // dew point derived from temp/hum (not part of the schema)
+
+  void reset(uint32_t periodStart);
+};
+
+enum SummaryPeriod {
+  SUMMARY_HOUR,
+  SUMMARY_DAY,
+  SUMMARY_WEEK,   // same week partitioning as the week files
+  SUMMARY_BOOT,   // since power-on (survives deep sleep wake-ups)
+  SUMMARY_PERIODS
+};
+
+// Constant-time summary of the logged samples for the current hour/day/week and since boot.
+// Updated per sample, checkpointed to flash at flush time so a reset keeps the running periods
+class Summary {
+public:
+  Summary();
+
+  // Restore the checkpoint; the boot period is only taken over when keepBoot is set
+  // (wake-up from deep sleep), otherwise it starts empty
+  bool load(bool keepBoot);
+
+  // Write the checkpoint (temp file + rename, like settings.json)
+  bool save();
+
+  // Add one logged sample; rolls periods over when ts is past their end
+  void add(const Measurement& m);
+
+  const PeriodStats& period(SummaryPeriod p) const { return periods[p]; }
+  static const char* periodName(SummaryPeriod p);
+
+  // Magnus formula (Sonntag 1990 constants), accurate to ~0.4 K for -45..60 C
+  static float dewPoint(float temp, float hum);
+
+private:
+  PeriodStats periods[SUMMARY_PERIODS];
+  bool dirty = false;
+
+  static uint32_t periodStart(SummaryPeriod p, uint32_t ts);
+};
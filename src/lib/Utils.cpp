@@ -2,6 +2,7 @@
 #include "Utils.h"
 #include <ESP8266WiFi.h>
 #include "time.h"
+#include <sys/time.h>
 
 Utils::Utils() : ntpInitialized(false), bootEpoch(0), bootMillis(0), lastWifiTry(0) {}
 
@@ -10,39 +11,89 @@ void Utils::begin() {
   bootMillis = millis();
 }
 
-void Utils::connectWiFi(const char* ssid, const char* pass) {
-  if (WiFi.status() == WL_CONNECTED) return;
-  Serial.printf("Utils: connecting to WiFi \"%s\"", ssid);
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid, pass);
+bool Utils::connectWiFi(const char* ssid, const char* pass, unsigned long timeoutMs) {
+  if (ssid) {
+    wifiSsid = ssid;
+    wifiPass = pass ? pass : "";
+  }
+  if (WiFi.status() == WL_CONNECTED) return true;
+  if (wifiSsid.length() == 0) return false;
+  lastWifiTry = millis();
+  Serial.printf("Utils: connecting to WiFi \"%s\"", wifiSsid.c_str());
+  WiFi.mode(apActive ? WIFI_AP_STA : WIFI_STA);
+  WiFi.begin(wifiSsid.c_str(), wifiPass.c_str());
+  if (timeoutMs == 0) {
+    Serial.println(" (in background)");
+    return false;
+  }
+  unsigned long start = millis();
   while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start >= timeoutMs) {
+      Serial.println(" timeout!");
+      return false;
+    }
     delay(500);
     Serial.print(".");
   }
   Serial.print("Connected! IP: ");
   Serial.println(WiFi.localIP());
+  return true;
+}
+
+void Utils::startConfigAP() {
+  if (apActive) return;
+  WiFi.mode(WIFI_AP_STA);
+  apActive = WiFi.softAP(CONFIG_AP_SSID);
+  if (apActive) {
+    Serial.print(F("Utils: config access point \"" CONFIG_AP_SSID "\" at "));
+    Serial.println(WiFi.softAPIP());
+  }
 }
 
-void Utils::initNTP() {
+bool Utils::initNTP(unsigned long timeoutMs) {
   // Use system configTime
   configTime(0, 0, "0.europe.pool.ntp.org", "time.google.com");
   ntpInitialized = true;
 
+  if (timeoutMs == 0) return time(nullptr) >= 8 * 3600 * 2;
+
   Serial.print("Waiting for NTP time..");
+    unsigned long start = millis();
     time_t now = 0;
     while (now < 8 * 3600 * 2) { // arbitrary check: time > Jan 2 1970
+        if (millis() - start >= timeoutMs) {
+            Serial.println(" timeout!");
+            return false;
+        }
         delay(500);                // wait 500 ms
         now = time(nullptr);
         Serial.print(".");
     }
     Serial.println("NTP synced!");
+    return true;
+}
+
+void Utils::setEpoch(time_t now) {
+  bootEpoch = now;
+  bootMillis = millis();
+  timeval tv = { now, 0 };
+  settimeofday(&tv, nullptr);
 }
 
 void Utils::handle() {
   // if not connected attempt reconnect (WiFi reconnect is handled by system but we can try)
   if (WiFi.status() != WL_CONNECTED) {
-    connectWiFi(NULL, NULL); // will just attempt reconnect
+    // the core keeps reconnecting on its own; start a fresh attempt now and then, without waiting
+    if (millis() - lastWifiTry >= (unsigned long)WIFI_RETRY_INTERVAL) {
+      connectWiFi(NULL, NULL, 0);
+    }
   } else {
+    if (apActive) {
+      Serial.println(F("Utils: WiFi connected, closing config access point"));
+      WiFi.softAPdisconnect(true);
+      WiFi.mode(WIFI_STA);
+      apActive = false;
+    }
     // if connected and ntp not initialized properly, request
     if (!ntpInitialized) {
       initNTP();
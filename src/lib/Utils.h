@@ -2,18 +2,30 @@
 #pragma once
 #include <Arduino.h>
 
+#define CONFIG_AP_SSID "Datalogger-Setup" // web UI at 192.168.4.1
+
 class Utils {
 public:
   Utils();
   void begin();
 
-  // WiFi connect (non-blocking attempt)
-  void connectWiFi(const char* ssid, const char* pass);
+  // WiFi connect: waits up to timeoutMs, timeoutMs = 0 only starts the attempt and returns.
+  // ssid = nullptr retries with the last credentials. Returns true if connected
+  bool connectWiFi(const char* ssid, const char* pass, unsigned long timeoutMs = 0);
+
+  // Open access point for configuration when the station cannot connect (e.g. wrong
+  // credentials). The station keeps retrying; the AP closes once it is connected
+  void startConfigAP();
+  bool configApActive() const { return apActive; }
+
+  // Init NTP (configTime): waits up to timeoutMs for the sync, timeoutMs = 0 returns at
+  // once (the sync then happens in the background). Returns true if synced
+  bool initNTP(unsigned long timeoutMs = 0);
 
-  // Init NTP (configTime)
-  void initNTP();
+  // Set the clock from an external estimate (e.g. carried over deep sleep in RTC memory)
+  void setEpoch(time_t now);
 
-  // handle periodics (reconnect attempts, NTP checks)
+  // handle periodics (reconnect attempts every WIFI_RETRY_INTERVAL, NTP checks); never blocks
   void handle();
 
   // Return current epoch time (NTP-backed if available, else millis-based)
@@ -28,4 +40,7 @@ private:
   unsigned long bootMillis;
   const int WIFI_RETRY_INTERVAL = 30000; // try reconnect every 30s
   unsigned long lastWifiTry = 0;
+  String wifiSsid;  // credentials of the last connect, for reconnect attempts
+  String wifiPass;
+  bool apActive = false;
 };
@@ -1,14 +1,15 @@
 // lib/Webserver.cpp
 #include "Webserver.h"
+#include "RecordSchema.h"
+#include "Gzip.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 
 WebserverHandler::WebserverHandler() : server(80), storage(nullptr), utils(nullptr) {}
 
-void WebserverHandler::begin(Storage* storagePtr, Utils* utilsPtr, const String& httpPassword) {
+void WebserverHandler::begin(Storage* storagePtr, Utils* utilsPtr) {
   storage = storagePtr;
   utils = utilsPtr;
-  password = httpPassword;
   setupRoutes();
   server.begin();
   Serial.println(F("Webserver started on port 80"));
@@ -19,6 +20,10 @@ void WebserverHandler::handleClient() {
 }
 
 void WebserverHandler::setupRoutes() {
+  // Only collected headers are readable via server.header() (Authorization is always collected)
+  static const char* headerKeys[] = { "X-Auth", "Range", "If-Range", "Accept-Encoding" };
+  server.collectHeaders(headerKeys, sizeof(headerKeys) / sizeof(headerKeys[0]));
+
   server.on("/api/weeks",          HTTP_GET,  [this]() { handleGetWeeks(); });
   server.on("/api/storageinfo",    HTTP_GET,  [this]() { handleGetStorageInfo(); });
   server.on("/api/download_week",  HTTP_GET,  [this]() { handleDownloadWeek(); });
@@ -32,6 +37,9 @@ void WebserverHandler::setupRoutes() {
   server.on("/api/flush",          HTTP_POST, [this]() { handleFlushBuffer(); });
   server.on("/api/set_interval",   HTTP_POST, [this]() { handleSetInterval(); });
   server.on("/api/latestMeasurement", HTTP_GET, [this]() { handleLastMeasurement(); });
+  server.on("/api/summary",        HTTP_GET,  [this]() { handleSummary(); });
+  server.on("/api/schema",         HTTP_GET,  [this]() { handleSchema(); });
+  server.on("/api/import",         HTTP_POST, [this]() { handleImportDone(); }, [this]() { handleImportUpload(); });
 
 
   // Static files from LittleFS
@@ -91,7 +99,7 @@ void WebserverHandler::handleGetStorageInfo() {
     int T = intervals[i];
     // measurements/week = 10080 / T
     float measured = 10080.0f / (float)T;
-    float bytesPerWeek = measured * 30.0f;
+    float bytesPerWeek = measured * (float)RECORD_TYPICAL_LEN;
     if (bytesPerWeek <= 0.001f) bytesPerWeek = 1;
     int weeks = (int)( (float)total / bytesPerWeek );
     d[String(T)] = weeks;
@@ -101,6 +109,111 @@ void WebserverHandler::handleGetStorageInfo() {
   server.send(200, "application/json", out);
 }
 
+// Outcome of matching a Range header against the file size
+enum RangeResult { RANGE_NONE, RANGE_OK, RANGE_UNSATISFIABLE };
+
+// Single "bytes=a-b", "bytes=a-" or "bytes=-n" range (RFC 7233). Anything else (several
+// ranges, other units, syntax errors) is ignored and answered with the whole file
+static RangeResult parseRange(const String& spec, size_t size, size_t& first, size_t& last) {
+  if (!spec.startsWith("bytes=")) return RANGE_NONE;
+  const char* p = spec.c_str() + 6;
+  if (strchr(p, ',')) return RANGE_NONE;
+  char* end;
+
+  if (*p == '-') {
+    // suffix range: the last n bytes
+    unsigned long n = strtoul(p + 1, &end, 10);
+    if (end == p + 1 || *end) return RANGE_NONE;
+    if (n == 0 || size == 0) return RANGE_UNSATISFIABLE;
+    first = n < size ? size - n : 0;
+    last = size - 1;
+    return RANGE_OK;
+  }
+
+  unsigned long a = strtoul(p, &end, 10);
+  if (end == p || *end != '-') return RANGE_NONE;
+  const char* q = end + 1;
+  unsigned long b = 0;
+  bool open = (*q == 0);
+  if (!open) {
+    b = strtoul(q, &end, 10);
+    if (end == q || *end || b < a) return RANGE_NONE;
+  }
+  if (a >= size) return RANGE_UNSATISFIABLE;
+  first = a;
+  last = (open || b >= size) ? size - 1 : b;
+  return RANGE_OK;
+}
+
+// true if the Accept-Encoding header allows gzip (anything but "gzip;q=0")
+static bool acceptsGzip(const String& accept) {
+  int i = accept.indexOf("gzip");
+  if (i < 0) return false;
+  String params = accept.substring(i + 4);
+  int comma = params.indexOf(',');
+  if (comma >= 0) params = params.substring(0, comma);
+  params.replace(" ", "");
+  if (params.startsWith(";q=")) return params.substring(3).toFloat() > 0.0f;
+  return true;
+}
+
+// Print that hands every write to the server as one chunk of a chunked response.
+// Writes nothing once the client is gone, so the encoder stops instead of compressing the
+// rest of the file for nobody
+class ChunkedPrint : public Print {
+public:
+  explicit ChunkedPrint(ESP8266WebServer& s) : server(s) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override {
+    if (!server.client().connected()) return 0;
+    server.sendContent((const char*)buf, len);
+    return len;
+  }
+
+private:
+  ESP8266WebServer& server;
+};
+
+// Send the rest of f gzip-compressed (chunked, the compressed size is unknown up front).
+// Returns false without sending anything if the encoder does not get its memory. A client
+// that disconnects ends the response early
+bool WebserverHandler::sendGzipped(File& f, const char* contentType, const char* etag) {
+  ChunkedPrint chunks(server);
+  GzipEncoder gz(chunks);
+  if (!gz.begin()) {
+    Serial.println(F("gzip: not enough heap, sending uncompressed"));
+    return false;
+  }
+
+  server.sendHeader("Content-Encoding", "gzip");
+  server.sendHeader("ETag", etag);
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, contentType, "");
+
+  uint8_t buf[256];
+  size_t n;
+  bool ok = true;
+  while (ok && (n = f.read(buf, sizeof(buf))) > 0) ok = gz.write(buf, n);
+  if (ok) ok = gz.finish();
+  if (!ok) {
+    Serial.printf("gzip: client gone after %lu of %lu bytes, aborted\n", (unsigned long)gz.bytesIn(),
+                  (unsigned long)f.size());
+    server.client().stop();
+    return true;
+  }
+  server.sendContent("");
+
+  gzipStats.responses++;
+  gzipStats.bytesIn += gz.bytesIn();
+  gzipStats.bytesOut += gz.bytesOut();
+  gzipStats.cpuUs += gz.cpuMicros();
+  Serial.printf("gzip: %lu -> %lu bytes (%.2fx), %.1f us/KB\n",
+                (unsigned long)gz.bytesIn(), (unsigned long)gz.bytesOut(),
+                gz.bytesOut() ? (float)gz.bytesIn() / gz.bytesOut() : 0.0f,
+                gz.bytesIn() ? gz.cpuMicros() * 1024.0f / gz.bytesIn() : 0.0f);
+  return true;
+}
+
 void WebserverHandler::handleDownloadWeek() {
   if (!server.hasArg("week")) {
     server.send(400, "text/plain", "week query param required");
@@ -114,9 +227,78 @@ void WebserverHandler::handleDownloadWeek() {
     return;
   }
   File f = LittleFS.open(path, "r");
-  server.setContentLength(f.size());
+  size_t size = f.size();
+
+  // Week files are append-only: bytes once written never change while the file exists.
+  // So the ETag names the file generation (creation time) and stays valid while the week
+  // grows; resumes and tail fetches keep working. A deleted and recreated week gets a new
+  // ETag, and If-Range then falls back to the whole file. The gzip representation has its
+  // own ETag. Byte ranges are only served from the identity file, so only its ETag
+  // satisfies If-Range; any other validator gets the whole file (200)
+  char etag[16];
+  char gzipEtag[20];
+  snprintf(etag, sizeof(etag), "\"%lx\"", (unsigned long)f.getCreationTime());
+  snprintf(gzipEtag, sizeof(gzipEtag), "\"%lx-gz\"", (unsigned long)f.getCreationTime());
+
+  size_t first = 0, last = 0;
+  RangeResult range = RANGE_NONE;
+  if (server.hasHeader("Range")) {
+    String ifRange = server.header("If-Range");
+    if (ifRange.length() == 0 || ifRange == etag) {
+      range = parseRange(server.header("Range"), size, first, last);
+    }
+  }
+
+  server.sendHeader("Accept-Ranges", "bytes");
+  server.sendHeader("Vary", "Accept-Encoding");
   server.sendHeader("Content-Disposition", "attachment; filename=\"" + week + "\"");
-  server.streamFile(f, "text/csv");
+
+  if (range == RANGE_UNSATISFIABLE) {
+    // also the answer to a tail fetch when nothing was appended
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Content-Range", "bytes */" + String((unsigned long)size));
+    server.send(416, "text/plain", "");
+    f.close();
+    return;
+  }
+
+  if (range == RANGE_NONE) {
+    // ranges always refer to the uncompressed file, so only whole-file answers are compressed.
+    // A browser decodes the body and keeps identity bytes: X-Identity-ETag is the validator
+    // for resuming from their length
+    server.sendHeader("X-Identity-ETag", etag);
+    if (acceptsGzip(server.header("Accept-Encoding")) && sendGzipped(f, "text/csv", gzipEtag)) {
+      f.close();
+      return;
+    }
+    server.sendHeader("ETag", etag);
+    server.setContentLength(size);
+    server.streamFile(f, "text/csv");
+    f.close();
+    return;
+  }
+
+  server.sendHeader("ETag", etag);
+  if (!f.seek(first)) {
+    server.send(500, "text/plain", "seek failed");
+    f.close();
+    return;
+  }
+  size_t remaining = last - first + 1;
+  char contentRange[40];
+  snprintf(contentRange, sizeof(contentRange), "bytes %lu-%lu/%lu",
+           (unsigned long)first, (unsigned long)last, (unsigned long)size);
+  server.sendHeader("Content-Range", contentRange);
+  server.setContentLength(remaining);
+  server.send(206, "text/csv", "");
+
+  uint8_t buf[512];
+  while (remaining > 0) {
+    size_t n = f.read(buf, remaining < sizeof(buf) ? remaining : sizeof(buf));
+    if (n == 0) break;
+    if (server.client().write(buf, n) != n) break; // client gone
+    remaining -= n;
+  }
   f.close();
 }
 
@@ -145,7 +327,7 @@ void WebserverHandler::handleDeleteAll() {
     return;
   }
   String val = server.header("Authorization");
-  if (val != password) {
+  if (val != g_settings.httpPassword) {
     server.send(403, "text/plain", "forbidden");
     return;
   }
@@ -159,7 +341,7 @@ void WebserverHandler::handleDeletePrevious() {
     return;
   }
   String val = server.header("Authorization");
-  if (val != password) {
+  if (val != g_settings.httpPassword) {
     server.send(403, "text/plain", "forbidden");
     return;
   }
@@ -175,21 +357,13 @@ void WebserverHandler::handleDeletePrevious() {
 }
 
 void WebserverHandler::handleGetSettings() {
+  // Served from the in-RAM settings, passwords are never sent out
   DynamicJsonDocument doc(256);
-  // For simplicity, read settings.json
-  if (LittleFS.exists("/config/settings.json")) {
-    File f = LittleFS.open("/config/settings.json", "r");
-    String s;
-    while (f.available()) s += (char)f.read();
-    f.close();
-    server.send(200, "application/json", s);
-  } else {
-    doc["interval"] = 300;
-    doc["wifi_ssid"] = "";
-    doc["wifi_pass"] = "";
-    String out; serializeJson(doc, out);
-    server.send(200, "application/json", out);
-  }
+  doc["interval"] = g_settings.intervalSeconds;
+  doc["wifi_ssid"] = g_settings.wifiSsid;
+  doc["low_power"] = g_settings.lowPower;
+  String out; serializeJson(doc, out);
+  server.send(200, "application/json", out);
 }
 
 void WebserverHandler::handleSetSettings() {
@@ -198,38 +372,86 @@ void WebserverHandler::handleSetSettings() {
     return;
   }
   String val = server.header("X-Auth");
-  if (val != password) {
+  if (val != g_settings.httpPassword) {
     server.send(403, "text/plain", "forbidden");
     return;
   }
-  // Expect JSON body with interval, wifi_ssid, wifi_pass
-  String body = server.arg("plain");
+  // Expect JSON body with any of interval, wifi_ssid, wifi_pass, http_password, low_power
   DynamicJsonDocument doc(512);
-  auto err = deserializeJson(doc, body);
+  auto err = deserializeJson(doc, server.arg("plain"));
   if (err) {
     server.send(400, "text/plain", "invalid json");
     return;
   }
-  // write settings.json
-  if (!LittleFS.exists("/config")) {
-    LittleFS.mkdir("/config");
+
+  Settings updated = g_settings;
+  if (doc["interval"].is<uint32_t>())
+    updated.intervalSeconds = doc["interval"].as<uint32_t>();
+  if (doc["wifi_ssid"].is<const char*>())
+    updated.wifiSsid = doc["wifi_ssid"].as<const char*>();
+  if (doc["wifi_pass"].is<const char*>())
+    updated.wifiPass = doc["wifi_pass"].as<const char*>();
+  if (doc["http_password"].is<const char*>())
+    updated.httpPassword = doc["http_password"].as<const char*>();
+  if (doc["low_power"].is<bool>())
+    updated.lowPower = doc["low_power"].as<bool>();
+
+  if (updated.intervalSeconds == 0) {
+    server.send(400, "text/plain", "invalid interval");
+    return;
   }
-  File f = LittleFS.open("/config/settings.json", "w");
-  if (!f) {
+
+  if (!storage->saveSettings(updated)) {
     server.send(500, "text/plain", "cannot save settings");
     return;
   }
-  serializeJson(doc, f);
-  f.close();
+
+  bool intervalChanged = updated.intervalSeconds != g_settings.intervalSeconds;
+  bool wifiChanged = updated.wifiSsid != g_settings.wifiSsid || updated.wifiPass != g_settings.wifiPass;
+  g_settings = updated; // new http password is effective from the next request on
 
   server.send(200, "application/json", "{\"status\":\"ok\"}");
+
+  // Apply live (after the response, a WiFi change drops this connection)
+  if (intervalChanged && intervalChangedCallback) intervalChangedCallback();
+  if (wifiChanged && wifiChangedCallback) wifiChangedCallback();
 }
 
 void WebserverHandler::handleMeasurementStatus() {
   Serial.println(F("\"handleMeasurementStatus\" called"));
-  DynamicJsonDocument doc(64);
+  DynamicJsonDocument doc(512);
   doc["measurementActive"] = measurementActive;
-  doc["interval"] = g_interval_seconds / 60;
+  doc["interval"] = g_settings.intervalSeconds / 60;
+  doc["buffered"] = bufferedSamples();
+  doc["dropped"] = droppedSamples();
+
+  // WiFi state and the outcome of the last credentials change (none, connecting, ok,
+  // reverted, failed)
+  JsonObject wifi = doc.createNestedObject("wifi");
+  wifi["connected"] = WiFi.status() == WL_CONNECTED;
+  wifi["ssid"] = g_settings.wifiSsid;
+  wifi["config_ap"] = utils ? utils->configApActive() : false;
+  wifi["change"] = wifiChangeResult();
+
+  // Timing quality of the sampling clock
+  if (scheduler) {
+    const JitterStats& js = scheduler->stats();
+    JsonObject j = doc.createNestedObject("jitter");
+    j["samples"] = js.samples;
+    j["missed"] = js.missed;
+    j["resyncs"] = js.resyncs;
+    j["min_ms"] = js.minLateMs;
+    j["max_ms"] = js.maxLateMs;
+    j["mean_ms"] = js.samples ? (float)js.sumLateMs / js.samples : 0.0f;
+  }
+
+  // Compressed downloads: size vs. CPU trade-off
+  JsonObject gz = doc.createNestedObject("gzip");
+  gz["responses"] = gzipStats.responses;
+  gz["bytes_in"] = gzipStats.bytesIn;
+  gz["bytes_out"] = gzipStats.bytesOut;
+  gz["ratio"] = gzipStats.bytesOut ? (float)gzipStats.bytesIn / gzipStats.bytesOut : 0.0f;
+  gz["us_per_kb"] = gzipStats.bytesIn ? (float)gzipStats.cpuUs * 1024.0f / gzipStats.bytesIn : 0.0f;
 
   String out;
   serializeJson(doc, out);
@@ -280,24 +502,138 @@ void WebserverHandler::handleSetInterval() {
 
   uint32_t newInterval = doc["interval"] | 300;
 
-  g_interval_seconds  = newInterval*60;
-  intervalChangedCallback();
+  g_settings.intervalSeconds = newInterval*60;
+  if (intervalChangedCallback) intervalChangedCallback();
 
   Serial.printf("New interval set: every %d min\n", newInterval);
 
-  storage->saveSettings(g_interval_seconds, g_wifi_ssid, g_wifi_pass, g_http_password);
+  storage->saveSettings(g_settings);
 
   server.send(200, "application/json", "{\"status\":\"ok\"}");
 }
 
 void WebserverHandler::handleLastMeasurement() {
   DynamicJsonDocument doc(128);
-  doc["temp"] = lastTemp; // float
-  doc["hum"]  = lastHum;  // float
-  doc["ts"]   = lastTs;   // uint32_t
+  for (const Channel& c : RECORD_CHANNELS) {
+    doc[c.name] = last.*c.field; // float
+  }
+  doc["ts"] = last.ts;           // uint32_t
 
   String out;
   serializeJson(doc, out);
   server.send(200, "application/json", out);
 }
 
+// Record layout for the web UI (CSV columns after ts, units, decimals)
+void WebserverHandler::handleSchema() {
+  DynamicJsonDocument doc(512);
+  char sep[2] = { RECORD_SEPARATOR, 0 };
+  doc["separator"] = sep;
+  doc["record_max"] = RECORD_MAX_LEN;
+  doc["record_typical"] = RECORD_TYPICAL_LEN;
+  JsonArray arr = doc.createNestedArray("channels");
+  for (const Channel& c : RECORD_CHANNELS) {
+    JsonObject o = arr.createNestedObject();
+    o["name"] = c.name;
+    o["label"] = c.label;
+    o["unit"] = c.unit;
+    o["decimals"] = c.decimals;
+  }
+
+  String out;
+  serializeJson(doc, out);
+  server.send(200, "application/json", out);
+}
+
+// Running statistics per period, answered from RAM (no file access)
+static void addStat(JsonObject parent, const char* key, const RunningStat& rs) {
+  JsonObject o = parent.createNestedObject(key);
+  if (rs.count == 0) return;
+  o["mean"] = (float)rs.mean;
+  o["std"] = rs.stddev();
+  o["min"] = rs.min;
+  o["min_ts"] = rs.minTs;
+  o["max"] = rs.max;
+  o["max_ts"] = rs.maxTs;
+}
+
+void WebserverHandler::handleSummary() {
+  if (!summary) {
+    server.send(503, "application/json", "{\"error\":\"no summary\"}");
+    return;
+  }
+
+  DynamicJsonDocument doc(2048);
+  for (uint8_t i = 0; i < SUMMARY_PERIODS; i++) {
+    SummaryPeriod p = (SummaryPeriod)i;
+    const PeriodStats& ps = summary->period(p);
+    JsonObject o = doc.createNestedObject(Summary::periodName(p));
+    o["start"] = ps.start;
+    o["count"] = ps.channels[0].count;
+    for (size_t c = 0; c < RECORD_CHANNEL_COUNT; c++) addStat(o, RECORD_CHANNELS[c].name, ps.channels[c]);
+    addStat(o, "dew", ps.dew);
+  }
+
+  String out;
+  serializeJson(doc, out);
+  server.send(200, "application/json", out);
+}
+
+// Upload callback for /api/import: called per received chunk (multipart file upload)
+void WebserverHandler::handleImportUpload() {
+  HTTPUpload& upload = server.upload();
+
+  if (upload.status == UPLOAD_FILE_START) {
+    // Same protection as the delete APIs: "Authorization: <password>"
+    importAuthorized = server.hasHeader("Authorization") && server.header("Authorization") == g_settings.httpPassword;
+    if (!importAuthorized) return;
+    // Pending samples first, so restored and new data don't interleave within a batch
+    if (flushCallback) flushCallback();
+    delete importer;
+    importer = new Importer(*storage);
+    importStartMs = millis();
+    Serial.printf("Import: receiving %s\n", upload.filename.c_str());
+  } else if (upload.status == UPLOAD_FILE_WRITE) {
+    if (importer) importer->feed(upload.buf, upload.currentSize);
+  } else if (upload.status == UPLOAD_FILE_END) {
+    if (importer) importer->finish();
+  } else if (upload.status == UPLOAD_FILE_ABORTED) {
+    Serial.println(F("Import: upload aborted"));
+    if (importer) importer->finish();
+  }
+}
+
+void WebserverHandler::handleImportDone() {
+  if (!importAuthorized) {
+    server.send(server.hasHeader("Authorization") ? 403 : 401, "text/plain", "forbidden");
+    return;
+  }
+  if (!importer) {
+    server.send(400, "text/plain", "file upload required");
+    return;
+  }
+
+  unsigned long ms = millis() - importStartMs;
+  float kbps = ms > 0 ? (importer->bytes() / 1024.0f) / (ms / 1000.0f) : 0.0f;
+  Serial.printf("Import: %lu records (%lu rejected, %lu already stored), %lu bytes in %lu ms = %.1f KB/s\n",
+                (unsigned long)importer->records(), (unsigned long)importer->rejected(),
+                (unsigned long)importer->skipped(),
+                (unsigned long)importer->bytes(), ms, kbps);
+
+  DynamicJsonDocument doc(256);
+  doc["status"] = importer->failed() ? "error" : "ok";
+  doc["format"] = importer->isZip() ? "zip" : "csv";
+  doc["records"] = importer->records();
+  doc["rejected"] = importer->rejected();
+  doc["skipped"] = importer->skipped();
+  doc["bytes"] = importer->bytes();
+  doc["ms"] = ms;
+  doc["kbps"] = kbps;
+  String out;
+  serializeJson(doc, out);
+  server.send(importer->failed() ? 500 : 200, "application/json", out);
+
+  delete importer;
+  importer = nullptr;
+  importAuthorized = false;
+}
@@ -4,39 +4,46 @@
 #include <ESP8266WebServer.h>
 #include "Storage.h"
 #include "Utils.h"
+#include "Scheduler.h"
+#include "Importer.h"
+#include "Summary.h"
+#include "Gzip.h"
 
 // ---- Globals aus Hauptprogramm ----
-extern uint32_t g_interval_seconds;
-extern String g_wifi_ssid;
-extern String g_wifi_pass;
-extern String g_http_password;
+extern Settings g_settings;
+uint32_t bufferedSamples();
+uint32_t droppedSamples();
+const char* wifiChangeResult();
 // ----------------------------------
 
 class WebserverHandler {
 public:
   WebserverHandler();
-  void begin(Storage* storagePtr, Utils* utilsPtr, const String& httpPassword);
+  void begin(Storage* storagePtr, Utils* utilsPtr);
   void handleClient();
   bool isMeasurementActive() const { return measurementActive; }
   void setIntervalChangedCallback(void (*cb)()) { intervalChangedCallback = cb; }
   void setFlushCallback(void (*cb)()) { flushCallback = cb; }
-  void updateLastMeasurement(float t, float h, uint32_t ts) {
-        lastTemp = t;
-        lastHum = h;
-        lastTs = ts;
-  }
+  void setWifiChangedCallback(void (*cb)()) { wifiChangedCallback = cb; }
+  void setScheduler(Scheduler* s) { scheduler = s; }
+  void setSummary(Summary* s) { summary = s; }
+  void updateLastMeasurement(const Measurement& m) { last = m; }
 
 private:
   ESP8266WebServer server;
   Storage* storage;
   Utils* utils;
-  String password;
-  float lastTemp = 0;
-  float lastHum = 0;
-  uint32_t lastTs = 0;
+  Scheduler* scheduler = nullptr;
+  Summary* summary = nullptr;
+  Importer* importer = nullptr;   // only exists while an import upload is running
+  bool importAuthorized = false;
+  unsigned long importStartMs = 0;
+  Measurement last = {};
   bool measurementActive = true;
+  GzipStats gzipStats = {};
   void (*intervalChangedCallback)() = nullptr;
   void (*flushCallback)() = nullptr;
+  void (*wifiChangedCallback)() = nullptr;
 
   void setupRoutes();
   // handlers
@@ -54,4 +61,9 @@ private:
   void handleFlushBuffer();
   void handleSetInterval();
   void handleLastMeasurement();
+  void handleSummary();
+  void handleSchema();
+  bool sendGzipped(File& f, const char* contentType, const char* etag);
+  void handleImportUpload();
+  void handleImportDone();
 };
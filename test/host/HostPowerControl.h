@@ -0,0 +1,45 @@
+// test/host/HostPowerControl.h
+// PowerControl for host tests: "RTC memory" is a plain array that survives the simulated
+// resets, deepSleep() returns instead of resetting and only records the request.
+#pragma once
+#include <string.h>
+#include "lib/PowerControl.h"
+
+class HostPowerControl : public PowerControl {
+public:
+  HostPowerControl() { powerLoss(); }
+
+  bool readRtc(uint32_t offsetBlocks, void* data, size_t len) override {
+    if (offsetBlocks * 4 + len > sizeof(rtc)) return false;
+    memcpy(data, rtc + offsetBlocks * 4, len);
+    return true;
+  }
+  bool writeRtc(uint32_t offsetBlocks, const void* data, size_t len) override {
+    if (offsetBlocks * 4 + len > sizeof(rtc)) return false;
+    memcpy(rtc + offsetBlocks * 4, data, len);
+    return true;
+  }
+  bool wokeFromDeepSleep() override { return wokeFromSleep; }
+  void deepSleep(uint32_t seconds, bool radioOnWake) override {
+    sleeps++;
+    lastSleepSeconds = seconds;
+    lastRadioOnWake = radioOnWake;
+    wokeFromSleep = true; // the next boot is the timer wake-up
+  }
+
+  // Reset button / watchdog / crash: RTC memory survives
+  void reset() { wokeFromSleep = false; }
+  // Supply lost: RTC memory content is undefined
+  void powerLoss() {
+    memset(rtc, 0xA5, sizeof(rtc));
+    wokeFromSleep = false;
+  }
+
+  uint32_t sleeps = 0;
+  uint32_t lastSleepSeconds = 0;
+  bool lastRadioOnWake = false;
+
+private:
+  uint8_t rtc[512];
+  bool wokeFromSleep = false;
+};
@@ -0,0 +1,32 @@
+// test/host/check.h
+// Minimal assertions for the host tests: report every failed check, exit code = failures
+#pragma once
+#include <stdio.h>
+
+static int g_checks = 0;
+static int g_failures = 0;
+
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    g_checks++;                                                              \
+    if (!(cond)) {                                                           \
+      g_failures++;                                                          \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+    }                                                                        \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                                  \
+  do {                                                                                  \
+    g_checks++;                                                                         \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                               \
+    if (va_ != vb_) {                                                                   \
+      g_failures++;                                                                     \
+      fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld != %lld)\n", __FILE__, \
+              __LINE__, #a, #b, va_, vb_);                                              \
+    }                                                                                   \
+  } while (0)
+
+static int checkSummary(const char* name) {
+  printf("%s: %d checks, %d failed\n", name, g_checks, g_failures);
+  return g_failures ? 1 : 0;
+}
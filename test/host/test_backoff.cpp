@@ -0,0 +1,48 @@
+// test/host/test_backoff.cpp
+// The flush retry gate of ESP_Datalogger.cpp around the 32-bit millis() wrap (49.7 days)
+// and after 24.9 days without a failure, where a signed deadline compare turns negative.
+// millis() is 64 bit on the host; Backoff takes it as uint32_t, as the ESP8266 returns it.
+#include <Arduino.h>
+#include "check.h"
+#include "lib/Backoff.h"
+
+#define FLUSH_RETRY_MS 10000UL
+
+int main() {
+  Backoff backoff(FLUSH_RETRY_MS);
+
+  // Never failed: no wait, also past 2^31 ms uptime and across the wrap
+  hostVirtualMillis = 0;
+  CHECK(!backoff.waiting(millis()));
+  hostVirtualMillis = 0x80000000LL + 5;
+  CHECK(!backoff.waiting(millis()));
+  hostVirtualMillis = 0xFFFFFFFFLL;
+  CHECK(!backoff.waiting(millis()));
+  hostVirtualMillis = 0x100000000LL + 10;
+  CHECK(!backoff.waiting(millis()));
+
+  // Failure shortly before the wrap: waits FLUSH_RETRY_MS across it, then retries
+  hostVirtualMillis = 0xFFFFFFFFLL - 3000;
+  backoff.fail(millis());
+  CHECK(backoff.waiting(millis()));
+  hostVirtualMillis += 3000; // 0xFFFFFFFF
+  CHECK(backoff.waiting(millis()));
+  hostVirtualMillis += 1;    // wrapped to 0
+  CHECK(backoff.waiting(millis()));
+  hostVirtualMillis += FLUSH_RETRY_MS - 3002; // 1 ms before the end of the wait
+  CHECK(backoff.waiting(millis()));
+  hostVirtualMillis += 1;
+  CHECK(!backoff.waiting(millis()));
+
+  // A failure that is never followed by a success: still no wait 24.9 days later
+  hostVirtualMillis += 0x80000000LL;
+  CHECK(!backoff.waiting(millis()));
+
+  // Failure and success: the next failure waits again, a success ends the wait at once
+  backoff.fail(millis());
+  CHECK(backoff.waiting(millis()));
+  backoff.clear();
+  CHECK(!backoff.waiting(millis()));
+
+  return checkSummary("test_backoff");
+}
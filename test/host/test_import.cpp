@@ -0,0 +1,108 @@
+// test/host/test_import.cpp
+// Importer against week files that already exist: only records newer than the last one of
+// their week are appended (files stay sorted, a second import of the same backup adds
+// nothing), and a full flash ends the import instead of deleting old weeks.
+#include <string>
+#include <vector>
+#include <LittleFS.h>
+#include "check.h"
+#include "lib/Importer.h"
+#include "lib/RecordFormat.h"
+#include "lib/Storage.h"
+
+#define INTERVAL 300
+static const uint32_t START_TS = 1737504000;               // 2025-01-22 00:00 UTC, 2025-W04
+static const uint32_t W05 = 7 * 86400 / INTERVAL;          // first sample of 2025-W05
+
+static Measurement sample(uint32_t i) { return {START_TS + i * INTERVAL, 20.0f + (i % 10) / 10.0f, 50.0f}; }
+
+static std::string csv(const std::vector<uint32_t>& indices) {
+  std::string out;
+  char line[RECORD_MAX_LEN];
+  for (uint32_t i : indices) out.append(line, formatRecord(line, sample(i)));
+  return out;
+}
+
+// Upload in small chunks, like the multipart upload callback
+static void import(Importer& importer, const std::string& data) {
+  importer.begin();
+  for (size_t pos = 0; pos < data.size(); pos += 7) {
+    size_t n = data.size() - pos < 7 ? data.size() - pos : 7;
+    importer.feed((const uint8_t*)data.data() + pos, n);
+  }
+  importer.finish();
+}
+
+static std::vector<uint32_t> weekTimestamps(Storage& storage, const char* week) {
+  std::vector<uint32_t> ts;
+  String text;
+  if (!storage.readWeekCSV(week, text)) return ts;
+  int pos = 0, nl;
+  while ((nl = text.indexOf('\n', pos)) >= 0) {
+    ts.push_back((uint32_t)text.substring(pos, nl).toInt());
+    pos = nl + 1;
+  }
+  return ts;
+}
+
+static bool sorted(const std::vector<uint32_t>& ts) {
+  for (size_t i = 1; i < ts.size(); i++)
+    if (ts[i] <= ts[i - 1]) return false;
+  return true;
+}
+
+int main() {
+  Storage storage;
+  storage.begin();
+  Importer importer(storage);
+
+  // The logger wrote samples 0..99 of W04
+  std::vector<Measurement> logged;
+  for (uint32_t i = 0; i < 100; i++) logged.push_back(sample(i));
+  for (size_t i = 0; i < logged.size(); i += 50) CHECK(storage.saveBatch(&logged[i], 50));
+  CHECK_EQ(storage.lastTimestampInWeek(START_TS), sample(99).ts);
+  CHECK_EQ(storage.lastTimestampInWeek(sample(W05).ts), 0);
+
+  // Backup overlapping W04 (50..149) and reaching into W05, with one line out of order
+  std::vector<uint32_t> backup;
+  for (uint32_t i = 50; i < 150; i++) backup.push_back(i);
+  for (uint32_t i = W05; i < W05 + 20; i++) backup.push_back(i);
+  backup.push_back(W05 + 5);
+  std::string data = csv(backup);
+  import(importer, data);
+  CHECK(!importer.failed());
+  CHECK_EQ(importer.records(), 50 + 20);
+  CHECK_EQ(importer.skipped(), 50 + 1);
+
+  std::vector<uint32_t> w04 = weekTimestamps(storage, "2025-W04.csv");
+  CHECK_EQ(w04.size(), 150);
+  CHECK(sorted(w04));
+  std::vector<uint32_t> w05 = weekTimestamps(storage, "2025-W05.csv");
+  CHECK_EQ(w05.size(), 20);
+  CHECK(sorted(w05));
+
+  // The same backup again adds nothing
+  import(importer, data);
+  CHECK(!importer.failed());
+  CHECK_EQ(importer.records(), 0);
+  CHECK_EQ(importer.skipped(), backup.size());
+  CHECK_EQ(weekTimestamps(storage, "2025-W04.csv").size(), 150);
+  CHECK_EQ(weekTimestamps(storage, "2025-W05.csv").size(), 20);
+
+  // Flash above the 85 % limit: an import of an older week fails, no week is deleted
+  std::vector<String> before;
+  storage.listWeeks(before);
+  FsUsage fs = storage.getFsUsage();
+  LittleFS.totalBytes = fs.used + fs.used / 20;
+  std::vector<uint32_t> older;
+  for (uint32_t i = 0; i < 50; i++) older.push_back(i - 3 * W05); // 2025-W01
+  import(importer, csv(older));
+  CHECK(importer.failed());
+  CHECK_EQ(importer.records(), 0);
+  std::vector<String> after;
+  storage.listWeeks(after);
+  CHECK_EQ(after.size(), before.size());
+  CHECK_EQ(weekTimestamps(storage, "2025-W04.csv").size(), 150);
+
+  return checkSummary("test_import");
+}
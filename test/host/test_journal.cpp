@@ -0,0 +1,160 @@
+// test/host/test_journal.cpp
+// Drives Journal through resets like setup()/flushStep() in ESP_Datalogger.cpp: samples are
+// journaled, partly flushed, and replayed after a reset. Storage failures during the replay
+// (simulated by the FS shim) must not lose samples: they are kept, journaled and written
+// by the next flush. Every boot gets a fresh Journal, like the RAM after a reset.
+#include <algorithm>
+#include <vector>
+#include <LittleFS.h>
+#include "check.h"
+#include "HostPowerControl.h"
+#include "lib/Journal.h"
+#include "lib/Storage.h"
+
+#define INTERVAL 300
+static const uint32_t START_TS = 1737504000; // 2025-01-22 00:00 UTC, 2025-W04
+
+// the RAM buffer of ESP_Datalogger.cpp, refilled by the kept callback
+static std::vector<Measurement> g_ram;
+static uint32_t g_summarized = 0;
+static void summarize(const Measurement*, uint8_t len) { g_summarized += len; }
+static void keep(const Measurement* arr, uint8_t len) { g_ram.insert(g_ram.end(), arr, arr + len); }
+
+static Measurement sample(uint32_t i) { return {START_TS + i * INTERVAL, 20.0f + (i % 10) / 10.0f, 50.0f}; }
+
+// timestamps of all stored records, in file order
+static std::vector<uint32_t> storedTimestamps(Storage& storage) {
+  std::vector<uint32_t> ts;
+  std::vector<String> weeks;
+  storage.listWeeks(weeks);
+  for (String& w : weeks) {
+    String csv;
+    if (!storage.readWeekCSV(w, csv)) continue;
+    int pos = 0, nl;
+    while ((nl = csv.indexOf('\n', pos)) >= 0) {
+      ts.push_back((uint32_t)csv.substring(pos, nl).toInt());
+      pos = nl + 1;
+    }
+  }
+  return ts;
+}
+
+// Boot: replay like setup(); returns the number of samples written
+static uint16_t boot(HostPowerControl& power, Storage& storage, Journal*& journal) {
+  static RtcBuffer* rtc = nullptr;
+  delete journal;
+  delete rtc;
+  power.reset();
+  g_ram.clear();
+  rtc = new RtcBuffer(power);
+  journal = new Journal(*rtc);
+  journal->setReplayedCallback(summarize);
+  journal->setKeptCallback(keep);
+  return journal->replay(storage);
+}
+
+// Measure like performMeasurement(): RAM buffer + journal
+static void measure(Journal& journal, uint32_t i) {
+  g_ram.push_back(sample(i));
+  CHECK(journal.append(sample(i)));
+}
+
+// Flush like flushBuffer(): write the RAM buffer, then consume it from the journal
+static bool flush(Journal& journal, Storage& storage) {
+  if (g_ram.empty()) return true;
+  uint8_t written;
+  bool ok = storage.saveBatch(g_ram.data(), (uint8_t)g_ram.size(), &written);
+  journal.consume(written);
+  g_ram.erase(g_ram.begin(), g_ram.begin() + written);
+  return ok;
+}
+
+int main() {
+  Storage storage;
+  storage.begin();
+  HostPowerControl power;
+  Journal* journal = nullptr;
+
+  // Power-on: nothing to replay
+  CHECK_EQ(boot(power, storage, journal), 0);
+  CHECK_EQ(journal->count(), 0);
+
+  // 40 samples, the first 10 reach flash, then a reset
+  for (uint32_t i = 0; i < 40; i++) measure(*journal, i);
+  std::vector<Measurement> firstTen(g_ram.begin(), g_ram.begin() + 10);
+  CHECK(storage.saveBatch(firstTen.data(), 10));
+  journal->consume(10);
+  g_ram.erase(g_ram.begin(), g_ram.begin() + 10);
+  CHECK_EQ(journal->count(), 30);
+
+  // Replay while flash takes no writes: nothing is lost, all 30 go back to the RAM buffer
+  LittleFS.writeOpensLeft = 0;
+  CHECK_EQ(boot(power, storage, journal), 0);
+  LittleFS.writeOpensLeft = -1;
+  CHECK_EQ(journal->count(), 30);
+  CHECK_EQ(g_ram.size(), 30);
+  CHECK_EQ(g_ram.front().ts, sample(10).ts);
+  CHECK_EQ(g_ram.back().ts, sample(39).ts);
+  CHECK_EQ(storedTimestamps(storage).size(), 10);
+
+  // Another reset before the next flush: the kept samples are still journaled
+  CHECK_EQ(boot(power, storage, journal), 30);
+  CHECK_EQ(journal->count(), 0);
+  CHECK(g_ram.empty());
+  CHECK_EQ(g_summarized, 30);
+  CHECK_EQ(storedTimestamps(storage).size(), 40);
+
+  // Partial replay: the first batch is written, the rest is kept in order
+  for (uint32_t i = 40; i < 80; i++) measure(*journal, i);
+  LittleFS.writeOpensLeft = 1;
+  uint16_t written = boot(power, storage, journal);
+  LittleFS.writeOpensLeft = -1;
+  CHECK(written > 0);
+  CHECK(written < 40);
+  CHECK_EQ(journal->count(), 40 - written);
+  CHECK_EQ(g_ram.size(), 40 - written);
+  CHECK_EQ(g_ram.front().ts, sample(40 + written).ts);
+  CHECK_EQ(g_ram.back().ts, sample(79).ts);
+
+  // Measuring continues behind the kept samples, then a normal flush writes everything once
+  for (uint32_t i = 80; i < 85; i++) measure(*journal, i);
+  CHECK(flush(*journal, storage));
+  CHECK_EQ(journal->count(), 0);
+  CHECK_EQ(boot(power, storage, journal), 0);
+
+  std::vector<uint32_t> ts = storedTimestamps(storage);
+  CHECK_EQ(ts.size(), 85);
+  for (uint32_t i = 0; i < ts.size() && i < 85; i++) CHECK_EQ(ts[i], sample(i).ts);
+
+  // Power loss: RTC memory is garbage, nothing is replayed
+  for (uint32_t i = 85; i < 90; i++) measure(*journal, i);
+  power.powerLoss();
+#if JOURNAL_FLASH_LOG
+  // the flash log survives it
+  CHECK_EQ(boot(power, storage, journal), 5);
+#else
+  CHECK_EQ(boot(power, storage, journal), 0);
+#endif
+  CHECK_EQ(journal->count(), 0);
+
+  // A flush across a week boundary whose second file cannot be opened: the first week is
+  // written and leaves the buffer, a retry writes only the rest
+  const uint32_t W05 = 7 * 86400 / INTERVAL; // first sample of 2025-W05
+  for (uint32_t i = W05 - 6; i < W05 + 4; i++) measure(*journal, i);
+  LittleFS.writeOpensLeft = 1;
+  CHECK(!flush(*journal, storage));
+  LittleFS.writeOpensLeft = -1;
+  CHECK_EQ(journal->count(), 4);
+  CHECK_EQ(g_ram.size(), 4);
+  CHECK_EQ(g_ram.front().ts, sample(W05).ts);
+  CHECK(flush(*journal, storage));
+  CHECK_EQ(journal->count(), 0);
+
+  ts = storedTimestamps(storage);
+  for (uint32_t i = W05 - 6; i < W05 + 4; i++) {
+    CHECK_EQ(std::count(ts.begin(), ts.end(), sample(i).ts), 1);
+  }
+
+  delete journal;
+  return checkSummary("test_journal");
+}
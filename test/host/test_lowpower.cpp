@@ -0,0 +1,174 @@
+// test/host/test_lowpower.cpp
+// Drives LowPower through the boot sequence of ESP_Datalogger.cpp: wake-up, measure into
+// RTC memory, deep sleep, scheduled WiFi windows (also one without an access point),
+// resets and power loss. Every boot gets a fresh LowPower, like the RAM after a reset.
+// The window period is fixed in time, the number of wake-ups in between follows the interval.
+// Last, LowPower hands the shared RTC image over to the Journal when low-power mode is left.
+#include <vector>
+#include <LittleFS.h>
+#include "check.h"
+#include "HostPowerControl.h"
+#include "lib/Journal.h"
+#include "lib/LowPower.h"
+#include "lib/Storage.h"
+
+#define INTERVAL 300
+#define WAKES_PER_WIFI ((int)(LOWPOWER_WIFI_PERIOD_S / INTERVAL))
+static const uint32_t START_TS = 1737504000; // 2025-01-22 00:00 UTC
+
+static uint32_t g_summarized = 0;
+static void summarize(const Measurement*, uint8_t len) { g_summarized += len; }
+
+static uint32_t storedRecords(Storage& storage) {
+  std::vector<String> weeks;
+  storage.listWeeks(weeks);
+  uint32_t n = 0;
+  for (String& w : weeks) {
+    String csv;
+    if (!storage.readWeekCSV(w, csv)) continue;
+    for (unsigned int i = 0; i < csv.length(); i++) n += csv[i] == '\n';
+  }
+  return n;
+}
+
+// One boot as in setup(): returns true if it was a measure-and-sleep wake-up,
+// false if it was a WiFi window (flush, window ends without WiFi, sleep)
+static bool boot(HostPowerControl& power, Storage& storage, uint32_t& ts, uint32_t interval = INTERVAL) {
+  RtcBuffer rtc(power);
+  LowPower lp(power, rtc);
+  lp.setInterval(interval);
+  lp.setFlushedCallback(summarize);
+  bool resumed = lp.begin();
+  if (resumed) {
+    CHECK((uint32_t)lp.estimatedEpoch() >= ts - interval);
+    CHECK((uint32_t)lp.estimatedEpoch() <= ts + 2);
+  }
+  if (!lp.wifiDue()) {
+    CHECK(lp.record({ts, 20.0f + (ts / interval) % 10, 50.0f}, storage));
+    lp.sleep(ts, interval);
+    ts += interval;
+    return true;
+  }
+  // WiFi window: flash is brought up to date, then (no AP, no user) the window times out
+  CHECK(lp.flush(storage));
+  CHECK_EQ(lp.buffered(), 0);
+  lp.wifiDone();
+  lp.sleep(ts, interval);
+  ts += interval;
+  return false;
+}
+
+int main() {
+  Storage storage;
+  storage.begin();
+  HostPowerControl power;
+  uint32_t ts = START_TS;
+
+  // Power-on: no RTC state, WiFi window first (NTP + chance to connect)
+  CHECK(!boot(power, storage, ts));
+  CHECK_EQ(power.sleeps, 1);
+  CHECK_EQ(power.lastSleepSeconds, INTERVAL);
+  CHECK(!power.lastRadioOnWake);
+
+  // Measure-only wake-ups until the next scheduled window; the radio is only
+  // requested for the wake-up that brings the window
+  for (int i = 1; i < WAKES_PER_WIFI; i++) {
+    CHECK(boot(power, storage, ts));
+    CHECK_EQ(power.lastRadioOnWake, i == WAKES_PER_WIFI - 1);
+  }
+  CHECK_EQ(storedRecords(storage), 0); // everything still in RTC memory
+
+  // Scheduled window without an access point: samples reach flash, the device sleeps
+  // again and the window counter restarts
+  CHECK(!boot(power, storage, ts));
+  CHECK_EQ(storedRecords(storage), WAKES_PER_WIFI - 1);
+  CHECK_EQ(g_summarized, WAKES_PER_WIFI - 1);
+  for (int i = 1; i < WAKES_PER_WIFI; i++) CHECK(boot(power, storage, ts));
+  CHECK(!boot(power, storage, ts));
+  CHECK_EQ(storedRecords(storage), 2 * (WAKES_PER_WIFI - 1));
+
+  // Reset in the middle of a cycle: buffered samples survive, the next boot is a window
+  for (int i = 0; i < 5; i++) CHECK(boot(power, storage, ts));
+  power.reset();
+  CHECK(!boot(power, storage, ts));
+  CHECK_EQ(storedRecords(storage), 2 * (WAKES_PER_WIFI - 1) + 5);
+
+  // Power loss: RTC memory is garbage, nothing is restored, cycle starts over
+  for (int i = 0; i < 3; i++) CHECK(boot(power, storage, ts));
+  power.powerLoss();
+  {
+    RtcBuffer rtc(power);
+    LowPower lp(power, rtc);
+    CHECK(!lp.begin());
+    CHECK_EQ(lp.buffered(), 0);
+    CHECK(lp.wifiDue());
+  }
+
+  // Wake-ups per window follow the interval, so the window stays about hourly
+  {
+    RtcBuffer rtc(power);
+    LowPower lp(power, rtc);
+    CHECK_EQ(lp.wakesPerWifi(), 12);
+    lp.setInterval(900);
+    CHECK_EQ(lp.wakesPerWifi(), 4);
+    lp.setInterval(3600);
+    CHECK_EQ(lp.wakesPerWifi(), 1);
+    lp.setInterval(7200);
+    CHECK_EQ(lp.wakesPerWifi(), 1);
+  }
+  CHECK(!boot(power, storage, ts, 900));
+  for (int i = 1; i < 4; i++) {
+    CHECK(boot(power, storage, ts, 900));
+    CHECK_EQ(power.lastRadioOnWake, i == 3);
+  }
+  CHECK(!boot(power, storage, ts, 900));
+  // Interval longer than the period: every wake-up is a window
+  CHECK(!boot(power, storage, ts, 7200));
+  CHECK(power.lastRadioOnWake);
+  CHECK(!boot(power, storage, ts, 7200));
+
+  // A full RTC buffer goes to flash on its own, without a window
+  uint32_t before = storedRecords(storage);
+  {
+    RtcBuffer rtc(power);
+    LowPower lp(power, rtc);
+    lp.begin();
+    for (int i = 0; i < RTC_BUFFER_CAPACITY + 5; i++, ts += INTERVAL) CHECK(lp.record({ts, 21.0f, 40.0f}, storage));
+    CHECK_EQ(lp.buffered(), 5);
+  }
+  CHECK_EQ(storedRecords(storage), before + RTC_BUFFER_CAPACITY);
+
+  // Low-power mode switched off while flash takes no writes: the samples stay in the shared
+  // RTC image and loop() keeps the low-power cycle; once they are on flash the Journal
+  // (same RtcBuffer, replayed at boot) takes over and nothing is overwritten
+  power.reset();
+  {
+    RtcBuffer rtc(power);
+    Journal journal(rtc);
+    LowPower lp(power, rtc);
+    journal.replay(storage);
+    lp.begin();
+    before = storedRecords(storage);
+    for (int i = 0; i < 5; i++, ts += INTERVAL) CHECK(lp.record({ts, 22.0f, 45.0f}, storage));
+    LittleFS.writeOpensLeft = 0;
+    CHECK(!lp.flush(storage));
+    LittleFS.writeOpensLeft = -1;
+    CHECK_EQ(lp.buffered(), 5);
+    CHECK_EQ(journal.count(), 0);
+    CHECK(lp.flush(storage));
+    CHECK_EQ(rtc.count(), 0);
+    CHECK(journal.append({ts, 23.0f, 44.0f}));
+    ts += INTERVAL;
+    CHECK_EQ(rtc.count(), 1);
+    CHECK_EQ(journal.count(), 1);
+  }
+  power.reset();
+  {
+    RtcBuffer rtc(power);
+    Journal journal(rtc);
+    CHECK_EQ(journal.replay(storage), 1);
+  }
+  CHECK_EQ(storedRecords(storage), before + 6);
+
+  return checkSummary("test_lowpower");
+}
@@ -0,0 +1,250 @@
+// tools/collector/collector.cpp
+// Polls many dataloggers concurrently and appends their week files into a local
+// columnar store (see column_store.h). Only bytes appended since the last run are
+// ingested per week file.
+//
+// Usage: collector --out DIR [--threads N] [--per-device N] [--timeout MS] host[:port]...
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "column_store.h"
+#include "http_client.h"
+#include "record_parser.h"
+
+struct Device {
+  std::string host;
+  int port = 80;
+  std::string name;            // directory name (host_port)
+  std::deque<std::string> weeks; // pending week downloads
+  int active = 0;              // connections currently open to this device
+  bool listed = false;         // /api/weeks fetched
+  bool listing = false;
+};
+
+struct Totals {
+  std::atomic<uint64_t> records{0};
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> errors{0};
+};
+
+// Work dispatcher: a fixed pool of threads, at most perDevice connections per logger
+// (the ESP8266 serves one client at a time, more connections only queue up there)
+class Collector {
+public:
+  Collector(std::vector<Device> devs, std::string outDir, int perDevice, int timeoutMs)
+      : devices(std::move(devs)), out(std::move(outDir)), perDevice(perDevice), timeoutMs(timeoutMs) {}
+
+  void run(int threads) {
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++) pool.emplace_back([this] { worker(); });
+    for (auto& t : pool) t.join();
+  }
+
+  Totals totals;
+
+private:
+  std::vector<Device> devices;
+  std::string out;
+  int perDevice;
+  int timeoutMs;
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t rr = 0; // round-robin start so no device starves
+
+  struct Job {
+    Device* dev = nullptr;
+    std::string week; // empty = list weeks
+  };
+
+  // Next runnable job; false when everything is done
+  bool next(Job& job) {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      bool pending = false;
+      for (size_t i = 0; i < devices.size(); i++) {
+        Device& d = devices[(rr + i) % devices.size()];
+        bool hasWork = !d.listed || !d.weeks.empty();
+        if (hasWork || d.active > 0) pending = true;
+        if (!hasWork || d.active >= perDevice) continue;
+        if (!d.listed) {
+          if (d.listing) continue; // week list first, downloads follow
+          d.listing = true;
+          job = {&d, ""};
+        } else {
+          job = {&d, d.weeks.front()};
+          d.weeks.pop_front();
+        }
+        d.active++;
+        rr = (rr + i + 1) % devices.size();
+        return true;
+      }
+      if (!pending) return false;
+      cv.wait(lock);
+    }
+  }
+
+  void done(Job& job, std::vector<std::string>* weeks) {
+    std::lock_guard<std::mutex> lock(mtx);
+    job.dev->active--;
+    if (job.week.empty()) {
+      job.dev->listed = true;
+      if (weeks)
+        for (auto& w : *weeks) job.dev->weeks.push_back(w);
+    }
+    cv.notify_all();
+  }
+
+  void worker() {
+    Job job;
+    while (next(job)) {
+      if (job.week.empty()) {
+        std::vector<std::string> weeks;
+        listWeeks(*job.dev, weeks);
+        done(job, &weeks);
+      } else {
+        fetchWeek(*job.dev, job.week);
+        done(job, nullptr);
+      }
+    }
+  }
+
+  void listWeeks(Device& d, std::vector<std::string>& weeks) {
+    totals.requests++;
+    HttpResponse r = httpGet(d.host, d.port, "/api/weeks", timeoutMs);
+    if (r.status != 200) {
+      fprintf(stderr, "%s: /api/weeks failed (%d %s)\n", d.name.c_str(), r.status, r.error.c_str());
+      totals.errors++;
+      return;
+    }
+    // JSON array of strings, e.g. ["2025-W01.csv","2025-W02.csv"]
+    size_t pos = 0;
+    while ((pos = r.body.find('"', pos)) != std::string::npos) {
+      size_t end = r.body.find('"', pos + 1);
+      if (end == std::string::npos) break;
+      weeks.push_back(r.body.substr(pos + 1, end - pos - 1));
+      pos = end + 1;
+    }
+  }
+
+  void fetchWeek(Device& d, const std::string& week) {
+    std::string name = week;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) name.resize(name.size() - 4);
+    ColumnStore store;
+    if (!store.open(out + "/" + d.name + "/" + name)) {
+      fprintf(stderr, "%s: cannot open store for %s\n", d.name.c_str(), week.c_str());
+      totals.errors++;
+      return;
+    }
+
+    // Only fetch what was appended since the last run: the device answers 206 with the tail,
+    // or 416 if nothing is new. If-Range makes it send the whole file if the week was recreated
+    uint64_t have = store.csvBytes();
+    std::string extra;
+    if (have > 0 && !store.sourceEtag().empty())
+      extra = "Range: bytes=" + std::to_string(have) + "-\r\nIf-Range: " + store.sourceEtag() + "\r\n";
+
+    totals.requests++;
+    HttpResponse r = httpGet(d.host, d.port, "/api/download_week?week=" + week, timeoutMs, extra);
+    if (r.status == 416 && !extra.empty() && r.error.empty()) {
+      store.close(have);
+      return;
+    }
+    if ((r.status != 200 && r.status != 206) || !r.error.empty()) {
+      fprintf(stderr, "%s: %s failed (%d %s)\n", d.name.c_str(), week.c_str(), r.status, r.error.c_str());
+      totals.errors++;
+      store.close(store.csvBytes());
+      return;
+    }
+
+    std::string etag = headerValue(r.headers, "ETag");
+    size_t skip = 0; // bytes at the start of the body that are already stored
+    if (r.status == 206) {
+      // "bytes <first>-<last>/<size>", first must be where we stopped
+      std::string range = headerValue(r.headers, "Content-Range");
+      if (range.compare(0, 6, "bytes ") != 0 || strtoull(range.c_str() + 6, nullptr, 10) != have) {
+        fprintf(stderr, "%s: %s unexpected Content-Range '%s'\n", d.name.c_str(), week.c_str(), range.c_str());
+        totals.errors++;
+        store.close(have);
+        return;
+      }
+    } else if (r.body.size() < have || (!etag.empty() && !store.sourceEtag().empty() && etag != store.sourceEtag())) {
+      // deleted and recreated on the device: start this week over
+      fprintf(stderr, "%s: %s was recreated, re-ingesting\n", d.name.c_str(), week.c_str());
+      store.reset();
+      have = 0;
+    } else {
+      skip = (size_t)have;
+    }
+    store.setSourceEtag(etag);
+
+    uint64_t rejected = 0;
+    uint64_t before = store.records();
+    std::string_view fresh(r.body.data() + skip, r.body.size() - skip);
+    bool stored = true;
+    size_t used = parseRecords(fresh, [&](const Record& rec) { return stored = store.append(rec); }, &rejected);
+    if (!stored) {
+      // the rest stays unconsumed, the next run fetches it again
+      fprintf(stderr, "%s: %s cannot grow the store after %llu new records, rest left for the next run\n",
+              d.name.c_str(), week.c_str(), (unsigned long long)(store.records() - before));
+      totals.errors++;
+    }
+    totals.rejected += rejected;
+    totals.bytes += r.body.size();
+    store.close(have + used);
+    totals.records += store.records() - before;
+  }
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: collector --out DIR [--threads N] [--per-device N] [--timeout MS] host[:port]...\n");
+}
+
+int main(int argc, char** argv) {
+  std::string out;
+  int threads = 8, perDevice = 1, timeoutMs = 15000;
+  std::vector<Device> devices;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--out" && i + 1 < argc) out = argv[++i];
+    else if (a == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+    else if (a == "--per-device" && i + 1 < argc) perDevice = atoi(argv[++i]);
+    else if (a == "--timeout" && i + 1 < argc) timeoutMs = atoi(argv[++i]);
+    else if (a.rfind("--", 0) == 0) { usage(); return 2; }
+    else {
+      Device d;
+      size_t colon = a.rfind(':');
+      d.host = colon == std::string::npos ? a : a.substr(0, colon);
+      d.port = colon == std::string::npos ? 80 : atoi(a.c_str() + colon + 1);
+      d.name = d.host + "_" + std::to_string(d.port);
+      devices.push_back(d);
+    }
+  }
+  if (out.empty() || devices.empty() || threads < 1 || perDevice < 1) {
+    usage();
+    return 2;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  Collector c(std::move(devices), out, perDevice, timeoutMs);
+  c.run(threads);
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t bytes = c.totals.bytes;
+  printf("requests=%llu errors=%llu new_records=%llu rejected=%llu bytes=%llu time=%.2fs (%.1f KB/s)\n",
+         (unsigned long long)c.totals.requests.load(), (unsigned long long)c.totals.errors.load(),
+         (unsigned long long)c.totals.records.load(), (unsigned long long)c.totals.rejected.load(),
+         (unsigned long long)bytes, secs, secs > 0 ? bytes / 1024.0 / secs : 0.0);
+  return c.totals.errors ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+// tools/collector/column_store.cpp
+#include "column_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+bool MappedColumn::open(const std::string& path, size_t elemSize, uint64_t count) {
+  elem = elemSize;
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return false;
+  return reserve(count > 0 ? count : 1);
+}
+
+bool MappedColumn::reserve(uint64_t count) {
+  if (count <= capacity && map) return true;
+  uint64_t newCap = capacity ? capacity : 4096;
+  while (newCap < count) newCap *= 2;
+  if (map) munmap(map, capacity * elem);
+  map = nullptr;
+  if (ftruncate(fd, (off_t)(newCap * elem)) != 0) return false;
+  void* m = mmap(nullptr, newCap * elem, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (m == MAP_FAILED) return false;
+  map = static_cast<uint8_t*>(m);
+  capacity = newCap;
+  return true;
+}
+
+void MappedColumn::close(uint64_t count) {
+  if (fd < 0) return;
+  if (map) munmap(map, capacity * elem);
+  if (ftruncate(fd, (off_t)(count * elem)) != 0) perror("ftruncate");
+  ::close(fd);
+  fd = -1;
+  map = nullptr;
+  capacity = 0;
+}
+
+static void makeDirs(const std::string& dir) {
+  for (size_t p = 1; p <= dir.size(); p++) {
+    if (p == dir.size() || dir[p] == '/') mkdir(dir.substr(0, p).c_str(), 0755);
+  }
+}
+
+bool ColumnStore::open(const std::string& d) {
+  dir = d;
+  makeDirs(dir);
+  count = consumed = 0;
+  etag.clear();
+  if (FILE* f = fopen((dir + "/meta").c_str(), "r")) {
+    unsigned long long c = 0, b = 0;
+    char e[64];
+    int fields = fscanf(f, "%llu %llu %63s", &c, &b, e);
+    if (fields >= 2) {
+      count = c;
+      consumed = b;
+    }
+    if (fields == 3) etag = e;
+    fclose(f);
+  }
+  if (!ts.open(dir + "/ts.u32", 4, count) || !temp.open(dir + "/temp.i16", 2, count) ||
+      !hum.open(dir + "/hum.i16", 2, count))
+    return false;
+  if (count > 0) memcpy(&last, ts.data() + (count - 1) * 4, 4);
+  return true;
+}
+
+bool ColumnStore::append(const Record& r) {
+  if (!ts.reserve(count + 1) || !temp.reserve(count + 1) || !hum.reserve(count + 1)) return false;
+  memcpy(ts.data() + count * 4, &r.ts, 4);
+  memcpy(temp.data() + count * 2, &r.temp10, 2);
+  memcpy(hum.data() + count * 2, &r.hum10, 2);
+  last = r.ts;
+  count++;
+  return true;
+}
+
+bool ColumnStore::close(uint64_t csvBytes) {
+  consumed = csvBytes;
+  ts.close(count);
+  temp.close(count);
+  hum.close(count);
+  // meta last: a crash before this point only re-ingests the same CSV bytes
+  std::string tmp = dir + "/meta.tmp";
+  FILE* f = fopen(tmp.c_str(), "w");
+  if (!f) return false;
+  fprintf(f, "%llu %llu %s\n", (unsigned long long)count, (unsigned long long)consumed, etag.c_str());
+  fclose(f);
+  return rename(tmp.c_str(), (dir + "/meta").c_str()) == 0;
+}
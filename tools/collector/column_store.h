@@ -0,0 +1,57 @@
+// tools/collector/column_store.h
+// Append-only columnar store for one week of one logger, backed by memory-mapped files:
+//   <dir>/ts.u32   uint32 timestamps
+//   <dir>/temp.i16 int16 temperature * 10
+//   <dir>/hum.i16  int16 humidity * 10
+//   <dir>/meta     "<records> <csv bytes consumed> [<etag>]" (for incremental fetches)
+#pragma once
+#include <cstdint>
+#include <string>
+#include "record_parser.h"
+
+class MappedColumn {
+public:
+  MappedColumn() = default;
+  MappedColumn(const MappedColumn&) = delete;
+  MappedColumn& operator=(const MappedColumn&) = delete;
+  ~MappedColumn() { close(0); }
+
+  bool open(const std::string& path, size_t elemSize, uint64_t count);
+  // Make room for `count` elements (grows the mapping geometrically)
+  bool reserve(uint64_t count);
+  uint8_t* data() { return map; }
+  // Unmap and truncate the file to exactly `count` elements
+  void close(uint64_t count);
+
+private:
+  int fd = -1;
+  uint8_t* map = nullptr;
+  size_t elem = 0;
+  uint64_t capacity = 0; // elements
+};
+
+class ColumnStore {
+public:
+  bool open(const std::string& dir);
+  // False if the columns cannot grow (disk full); the record is not stored
+  bool append(const Record& r);
+  // Drop all records (the source file was recreated)
+  void reset() { count = 0; consumed = 0; last = 0; etag.clear(); }
+  // Persist sizes and the consumed CSV byte offset
+  bool close(uint64_t csvBytes);
+
+  uint64_t records() const { return count; }
+  uint64_t csvBytes() const { return consumed; }
+  uint32_t lastTs() const { return last; }
+  // ETag of the device file the consumed bytes came from (empty if unknown)
+  const std::string& sourceEtag() const { return etag; }
+  void setSourceEtag(const std::string& e) { etag = e; }
+
+private:
+  std::string dir;
+  MappedColumn ts, temp, hum;
+  uint64_t count = 0;
+  uint64_t consumed = 0;
+  uint32_t last = 0;
+  std::string etag;
+};
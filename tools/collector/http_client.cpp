@@ -0,0 +1,130 @@
+// tools/collector/http_client.cpp
+#include "http_client.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <strings.h>
+
+static int connectTo(const std::string& host, int port, int timeoutMs, std::string& error) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  std::string portStr = std::to_string(port);
+  if (int rc = getaddrinfo(host.c_str(), portStr.c_str(), &hints, &res)) {
+    error = std::string("resolve: ") + gai_strerror(rc);
+    return -1;
+  }
+  int fd = -1;
+  for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) continue;
+    timeval tv{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(res);
+  if (fd < 0) error = std::string("connect: ") + strerror(errno);
+  return fd;
+}
+
+static bool sendAll(int fd, const std::string& data) {
+  size_t off = 0;
+  while (off < data.size()) {
+    ssize_t n = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    off += (size_t)n;
+  }
+  return true;
+}
+
+std::string headerValue(const std::string& headers, const std::string& name) {
+  size_t pos = 0;
+  while (pos < headers.size()) {
+    size_t eol = headers.find("\r\n", pos);
+    if (eol == std::string::npos) eol = headers.size();
+    size_t colon = headers.find(':', pos);
+    if (colon != std::string::npos && colon < eol && colon - pos == name.size() &&
+        strncasecmp(headers.data() + pos, name.data(), name.size()) == 0) {
+      size_t v = colon + 1;
+      while (v < eol && headers[v] == ' ') v++;
+      return headers.substr(v, eol - v);
+    }
+    pos = eol + 2;
+  }
+  return "";
+}
+
+// Decode a chunked body in place, returns false if it is truncated
+static bool dechunk(std::string& body) {
+  std::string out;
+  size_t pos = 0;
+  while (true) {
+    size_t eol = body.find("\r\n", pos);
+    if (eol == std::string::npos) return false;
+    size_t len = strtoul(body.c_str() + pos, nullptr, 16);
+    pos = eol + 2;
+    if (len == 0) break;
+    if (pos + len > body.size()) return false;
+    out.append(body, pos, len);
+    pos += len + 2;
+  }
+  body.swap(out);
+  return true;
+}
+
+HttpResponse httpGet(const std::string& host, int port, const std::string& path,
+                     int timeoutMs, const std::string& extraHeaders) {
+  HttpResponse r;
+  int fd = connectTo(host, port, timeoutMs, r.error);
+  if (fd < 0) return r;
+
+  std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n" +
+                    extraHeaders + "\r\n";
+  if (!sendAll(fd, req)) {
+    r.error = "send failed";
+    close(fd);
+    return r;
+  }
+
+  std::string raw;
+  char buf[16384];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) raw.append(buf, (size_t)n);
+  close(fd);
+  if (n < 0 && raw.empty()) {
+    r.error = "receive timeout";
+    return r;
+  }
+
+  size_t hdrEnd = raw.find("\r\n\r\n");
+  if (hdrEnd == std::string::npos || raw.compare(0, 5, "HTTP/") != 0) {
+    r.error = "malformed response";
+    return r;
+  }
+  r.status = atoi(raw.c_str() + raw.find(' ') + 1);
+  size_t firstEol = raw.find("\r\n");
+  r.headers = raw.substr(firstEol + 2, hdrEnd - firstEol);
+  r.body = raw.substr(hdrEnd + 4);
+
+  std::string te = headerValue(r.headers, "Transfer-Encoding");
+  if (strcasecmp(te.c_str(), "chunked") == 0) {
+    if (!dechunk(r.body)) r.error = "truncated chunked body";
+  } else {
+    std::string cl = headerValue(r.headers, "Content-Length");
+    if (!cl.empty() && r.body.size() < strtoul(cl.c_str(), nullptr, 10)) r.error = "truncated body";
+  }
+  return r;
+}
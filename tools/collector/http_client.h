@@ -0,0 +1,19 @@
+// tools/collector/http_client.h
+// Minimal blocking HTTP/1.1 GET client (POSIX sockets), enough for the logger API.
+#pragma once
+#include <string>
+
+struct HttpResponse {
+  int status = 0;
+  std::string headers; // raw header block (lower-cased names are not normalised)
+  std::string body;
+  std::string error;   // set if the request failed before a status was received
+};
+
+// GET http://host:port/path. Handles Content-Length, chunked and close-delimited bodies.
+// extraHeaders are sent verbatim (each line terminated by "\r\n").
+HttpResponse httpGet(const std::string& host, int port, const std::string& path,
+                     int timeoutMs = 10000, const std::string& extraHeaders = "");
+
+// Value of a response header (case-insensitive name), empty if missing
+std::string headerValue(const std::string& headers, const std::string& name);
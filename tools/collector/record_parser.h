@@ -0,0 +1,78 @@
+// tools/collector/record_parser.h
+// Zero-copy parser for the logger's "ts;temp;hum\n" week files.
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+struct Record {
+  uint32_t ts;
+  int16_t temp10; // temperature * 10 (the logger writes one decimal)
+  int16_t hum10;  // humidity * 10
+};
+
+// Parse "[-]123[.4]" into value*10 without going through float. Advances p.
+inline bool parseFixed1(const char*& p, const char* end, int16_t& out) {
+  bool neg = false;
+  if (p < end && *p == '-') { neg = true; p++; }
+  if (p >= end || *p < '0' || *p > '9') return false;
+  int32_t v = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p++ - '0');
+    if (v > 32767) return false;
+  }
+  v *= 10;
+  if (p < end && *p == '.') {
+    p++;
+    if (p >= end || *p < '0' || *p > '9') return false;
+    int d = *p++ - '0';
+    // more decimals: round on the second one, ignore the rest
+    if (p < end && *p >= '5' && *p <= '9') d++;
+    while (p < end && *p >= '0' && *p <= '9') p++;
+    v += d;
+  }
+  if (v > 32767) return false;
+  out = (int16_t)(neg ? -v : v);
+  return true;
+}
+
+// Parse one line [begin,end) (without '\n', optional trailing '\r')
+inline bool parseRecord(const char* p, const char* end, Record& r) {
+  if (end > p && end[-1] == '\r') end--;
+  uint64_t ts = 0;
+  if (p >= end || *p < '0' || *p > '9') return false;
+  while (p < end && *p >= '0' && *p <= '9') {
+    ts = ts * 10 + (uint64_t)(*p++ - '0');
+    if (ts > 0xFFFFFFFFULL) return false;
+  }
+  if (p >= end || *p++ != ';') return false;
+  if (!parseFixed1(p, end, r.temp10)) return false;
+  if (p >= end || *p++ != ';') return false;
+  if (!parseFixed1(p, end, r.hum10)) return false;
+  if (p != end) return false;
+  r.ts = (uint32_t)ts;
+  return true;
+}
+
+// Calls fn(const Record&) for every valid complete line in text. Returns the number of
+// bytes consumed (up to and including the last '\n'); a trailing partial line is left
+// for the next fetch. Invalid lines are counted in *rejected. If fn returns false the
+// record could not be stored: parsing stops and that line is not consumed either.
+template <typename Fn>
+size_t parseRecords(std::string_view text, Fn&& fn, uint64_t* rejected = nullptr) {
+  const char* base = text.data();
+  const char* end = base + text.size();
+  const char* line = base;
+  while (line < end) {
+    const char* nl = static_cast<const char*>(memchr(line, '\n', (size_t)(end - line)));
+    if (!nl) break;
+    Record r;
+    if (parseRecord(line, nl, r)) {
+      if (!fn(r)) break;
+    } else if (rejected && nl > line) {
+      (*rejected)++;
+    }
+    line = nl + 1;
+  }
+  return (size_t)(line - base);
+}
@@ -0,0 +1,186 @@
+// tools/collector/standin_server.cpp
+// Local stand-in for one or more dataloggers, for testing the collector without hardware.
+// Serves /api/weeks and /api/download_week with deterministic synthetic week files; the
+// newest week grows by one record per --grow-ms so incremental fetches can be exercised.
+// Like the device it answers "Range: bytes=N-" (with If-Range) with 206/416.
+//
+// Usage: standin_server [--port 8081] [--count N] [--weeks 4] [--interval 300] [--grow-ms 0]
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int g_weeks = 4;
+static int g_interval = 300;
+static int g_growMs = 0;
+static const uint32_t BASE_TS = 1735689600; // 2025-01-01 00:00 UTC (day 0 of week W01)
+static const auto g_start = std::chrono::steady_clock::now();
+
+static std::string weekName(int w) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "2025-W%02d.csv", w + 1);
+  return buf;
+}
+
+// Same record format as Storage::saveBatch on the device
+static std::string weekCsv(int w, int port) {
+  uint32_t perWeek = 7 * 86400 / g_interval;
+  uint32_t n = perWeek;
+  if (w == g_weeks - 1) {
+    // newest week: half full, growing over time
+    n = perWeek / 2;
+    if (g_growMs > 0) {
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - g_start).count();
+      n += (uint32_t)(ms / g_growMs);
+      if (n > perWeek) n = perWeek;
+    }
+  }
+  std::string out;
+  out.reserve(n * 20);
+  char line[40];
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t ts = BASE_TS + (uint32_t)w * 7 * 86400 + i * g_interval;
+    double t = 20.0 + 5.0 * sin(i / 40.0 + port);
+    double h = 50.0 + 10.0 * cos(i / 55.0);
+    int len = snprintf(line, sizeof(line), "%lu;%.1f;%.1f\n", (unsigned long)ts, t, h);
+    out.append(line, (size_t)len);
+  }
+  return out;
+}
+
+static const char* reason(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 416: return "Range Not Satisfiable";
+    default:  return "Not Found";
+  }
+}
+
+static void reply(int fd, int status, const char* type, const std::string& body, const std::string& extra = "") {
+  char hdr[256];
+  int n = snprintf(hdr, sizeof(hdr), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n",
+                   status, reason(status), type, body.size());
+  std::string all(hdr, (size_t)n);
+  all += extra + "\r\n";
+  all += body;
+  size_t off = 0;
+  while (off < all.size()) {
+    ssize_t w = send(fd, all.data() + off, all.size() - off, MSG_NOSIGNAL);
+    if (w <= 0) break;
+    off += (size_t)w;
+  }
+}
+
+// Value of a request header (names compared case-insensitively), empty if missing
+static std::string requestHeader(const std::string& req, const char* name) {
+  size_t len = strlen(name);
+  size_t pos = req.find("\r\n");
+  while (pos != std::string::npos && pos + 2 < req.size()) {
+    size_t start = pos + 2;
+    size_t end = req.find("\r\n", start);
+    if (end == std::string::npos || end == start) break;
+    if (end - start > len && req[start + len] == ':' && strncasecmp(req.c_str() + start, name, len) == 0) {
+      size_t v = start + len + 1;
+      while (v < end && req[v] == ' ') v++;
+      return req.substr(v, end - v);
+    }
+    pos = end;
+  }
+  return "";
+}
+
+// Week file on the device, incl. Range/If-Range handling (only "bytes=N-" is needed here)
+static void replyWeek(int fd, const std::string& req, const std::string& csv, int port) {
+  std::string etag = "\"" + std::to_string(port) + "\"";
+  std::string extra = "Accept-Ranges: bytes\r\nETag: " + etag + "\r\n";
+  std::string range = requestHeader(req, "Range");
+  std::string ifRange = requestHeader(req, "If-Range");
+  if (range.compare(0, 6, "bytes=") == 0 && range.back() == '-' && (ifRange.empty() || ifRange == etag)) {
+    size_t first = strtoull(range.c_str() + 6, nullptr, 10);
+    if (first >= csv.size()) {
+      reply(fd, 416, "text/plain", "", extra + "Content-Range: bytes */" + std::to_string(csv.size()) + "\r\n");
+      return;
+    }
+    extra += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(csv.size() - 1) + "/" +
+             std::to_string(csv.size()) + "\r\n";
+    reply(fd, 206, "text/csv", csv.substr(first), extra);
+    return;
+  }
+  reply(fd, 200, "text/csv", csv, extra);
+}
+
+static void serve(int fd, int port) {
+  std::string req;
+  char buf[2048];
+  while (req.find("\r\n\r\n") == std::string::npos) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) { close(fd); return; }
+    req.append(buf, (size_t)n);
+  }
+  size_t sp = req.find(' ');
+  std::string path = req.substr(sp + 1, req.find(' ', sp + 1) - sp - 1);
+
+  if (path == "/api/weeks") {
+    std::string body = "[";
+    for (int w = 0; w < g_weeks; w++) body += (w ? ",\"" : "\"") + weekName(w) + "\"";
+    reply(fd, 200, "application/json", body + "]");
+  } else if (path.rfind("/api/download_week?week=", 0) == 0) {
+    std::string week = path.substr(strlen("/api/download_week?week="));
+    if (week.find(".csv") == std::string::npos) week += ".csv";
+    int found = -1;
+    for (int w = 0; w < g_weeks; w++)
+      if (weekName(w) == week) found = w;
+    if (found < 0) reply(fd, 404, "text/plain", "week not found");
+    else replyWeek(fd, req, weekCsv(found, port), port);
+  } else {
+    reply(fd, 404, "text/plain", "Not found");
+  }
+  close(fd);
+}
+
+static void listenOn(int port) {
+  int s = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons((uint16_t)port);
+  if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 16) != 0) {
+    perror("bind/listen");
+    exit(1);
+  }
+  while (true) {
+    int c = accept(s, nullptr, nullptr);
+    if (c >= 0) std::thread(serve, c, port).detach();
+  }
+}
+
+int main(int argc, char** argv) {
+  int port = 8081, count = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string a = argv[i];
+    int v = atoi(argv[i + 1]);
+    if (a == "--port") port = v;
+    else if (a == "--count") count = v;
+    else if (a == "--weeks") g_weeks = v;
+    else if (a == "--interval") g_interval = v;
+    else if (a == "--grow-ms") g_growMs = v;
+  }
+  std::vector<std::thread> listeners;
+  for (int i = 0; i < count; i++) listeners.emplace_back(listenOn, port + i);
+  printf("stand-in loggers on 127.0.0.1:%d-%d (%d weeks, %d s interval)\n", port, port + count - 1, g_weeks, g_interval);
+  fflush(stdout);
+  for (auto& t : listeners) t.join();
+}
@@ -0,0 +1,468 @@
+// tools/loadtest/loadtest.cpp
+// Host load test for WebserverHandler: the firmware's Webserver/Storage modules run
+// unmodified against the shims in ./shim (in-memory LittleFS, in-process web server with
+// the connection handling of the ESP8266 core). Dashboard-like traffic mixes are replayed
+// in virtual time: simulated browsers open connections and send requests, and the
+// firmware's WebserverHandler::handleClient() is called once per loop() pass.
+//
+// Per route it reports host CPU time, heap allocations and response bytes. It also reports
+// modelled device latency: waiting for the server + CPU + transfer at --link-kBps, plus
+// --conn-ms for the TCP handshake when the browser has to open a new connection.
+// Each client is modelled as a browser: up to --parallel keep-alive connections, no
+// pipelining, optionally --spare preconnected sockets per page load that stay unused.
+//
+// Usage: loadtest [--seconds 600] [--link-kBps 50] [--conn-ms 15] [--rtt-ms 5] [--loop-ms 1] [--parallel 6]
+//                 [--spare 0] [--data ../../data] [--baseline baseline.txt] [--write-baseline baseline.txt]
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ESP8266WebServer.h>
+#include <LittleFS.h>
+#include "lib/Storage.h"
+#include "lib/Summary.h"
+#include "lib/Webserver.h"
+
+// ---- allocation counting ----
+// Not inlined: GCC would otherwise see free() on memory from operator new at the call sites
+// (-Wmismatched-new-delete), although both sides of the pair are replaced here
+#define ALLOC_HOOK __attribute__((noinline))
+static std::atomic<bool> g_counting{false};
+static std::atomic<uint64_t> g_allocs{0};
+
+ALLOC_HOOK void* operator new(size_t n) {
+  if (g_counting) g_allocs++;
+  if (void* p = malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+ALLOC_HOOK void* operator new[](size_t n) { return operator new(n); }
+ALLOC_HOOK void* operator new(size_t n, const std::nothrow_t&) noexcept {
+  if (g_counting) g_allocs++;
+  return malloc(n ? n : 1);
+}
+ALLOC_HOOK void* operator new[](size_t n, const std::nothrow_t& t) noexcept { return operator new(n, t); }
+ALLOC_HOOK void operator delete(void* p) noexcept { free(p); }
+ALLOC_HOOK void operator delete[](void* p) noexcept { operator delete(p); }
+ALLOC_HOOK void operator delete(void* p, size_t) noexcept { operator delete(p); }
+ALLOC_HOOK void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// ---- globals normally provided by ESP_Datalogger.cpp ----
+Settings g_settings = {300, "loadtest", "loadtest", "admin", false};
+uint32_t bufferedSamples() { return 3; }
+uint32_t droppedSamples() { return 0; }
+const char* wifiChangeResult() { return "none"; }
+
+struct RouteSpec {
+  const char* name;
+  const char* uri;
+  const char* acceptEncoding; // nullptr = no Accept-Encoding header
+};
+
+static const RouteSpec ROUTES[] = {
+  {"index", "/", nullptr},
+  {"schema", "/api/schema", nullptr},
+  {"style", "/style.css", nullptr},
+  {"script", "/script.js", nullptr},
+  {"storageinfo", "/api/storageinfo", nullptr},
+  {"weeks", "/api/weeks", nullptr},
+  {"status", "/api/status", nullptr},
+  {"latest", "/api/latestMeasurement", nullptr},
+  {"summary", "/api/summary", nullptr},
+  {"download_week", "/api/download_week?week=2025-W04.csv", nullptr},
+  {"download_week_gz", "/api/download_week?week=2025-W04.csv", "gzip, deflate"},
+};
+
+struct Arrival {
+  double atMs;
+  int route;
+  int client; // browser tab / poller; its requests share its keep-alive connections
+  int wave;   // a request of the next wave waits until the client has all responses
+  bool pageLoad;
+};
+
+// Traffic mixes (virtual time)
+struct Scenario {
+  const char* name;
+  const char* description;
+  std::vector<Arrival> (*generate)(double seconds, std::mt19937& rng);
+};
+
+static int routeIndex(const char* name) {
+  for (size_t i = 0; i < sizeof(ROUTES) / sizeof(ROUTES[0]); i++)
+    if (strcmp(ROUTES[i].name, name) == 0) return (int)i;
+  abort();
+}
+
+static int g_nextClient = 0;
+
+// Poisson process of one route, all requests from the same client
+static void poisson(std::vector<Arrival>& out, const char* route, double perSecond, double seconds, std::mt19937& rng) {
+  std::exponential_distribution<double> gap(perSecond);
+  int client = g_nextClient++;
+  for (double t = gap(rng); t < seconds; t += gap(rng)) out.push_back({t * 1000.0, routeIndex(route), client, 0, false});
+}
+
+// Dashboard page load: index.html first, then the requests it and script.js trigger
+static void pageLoads(std::vector<Arrival>& out, double perSecond, double seconds, std::mt19937& rng, bool withWeek) {
+  static const char* burst[] = {"style", "script", "schema", "storageinfo", "weeks", "status", "latest"};
+  std::exponential_distribution<double> gap(perSecond);
+  for (double t = gap(rng); t < seconds; t += gap(rng)) {
+    double at = t * 1000.0;
+    int client = g_nextClient++;
+    out.push_back({at, routeIndex("index"), client, 0, true});
+    for (const char* r : burst) out.push_back({at += 1.0, routeIndex(r), client, 1, true});
+    if (withWeek) out.push_back({at + 1.0, routeIndex("download_week"), client, 1, true});
+  }
+}
+
+static std::vector<Arrival> genPoll(double seconds, std::mt19937& rng) {
+  std::vector<Arrival> a;
+  poisson(a, "latest", 2.0, seconds, rng);
+  poisson(a, "status", 0.2, seconds, rng);
+  poisson(a, "summary", 0.2, seconds, rng);
+  return a;
+}
+
+static std::vector<Arrival> genDashboard(double seconds, std::mt19937& rng) {
+  std::vector<Arrival> a;
+  pageLoads(a, 1.0 / 20.0, seconds, rng, true);
+  poisson(a, "latest", 0.5, seconds, rng);
+  return a;
+}
+
+static std::vector<Arrival> genPollDownload(double seconds, std::mt19937& rng) {
+  std::vector<Arrival> a;
+  poisson(a, "latest", 2.0, seconds, rng);
+  poisson(a, "download_week", 1.0 / 15.0, seconds, rng);
+  return a;
+}
+
+static std::vector<Arrival> genPollDownloadGzip(double seconds, std::mt19937& rng) {
+  std::vector<Arrival> a;
+  poisson(a, "latest", 2.0, seconds, rng);
+  poisson(a, "download_week_gz", 1.0 / 15.0, seconds, rng);
+  return a;
+}
+
+static const Scenario SCENARIOS[] = {
+  {"poll", "live value polling (2 req/s) + status + summary", genPoll},
+  {"dashboard", "page loads every ~20 s incl. one week + polling", genDashboard},
+  {"poll_download", "polling 2 req/s overlapping full week downloads every ~15 s", genPollDownload},
+  {"poll_download_gz", "as poll_download, client sends Accept-Encoding: gzip", genPollDownloadGzip},
+};
+
+struct RouteStats {
+  std::vector<double> cpuUs;
+  std::vector<double> latencyMs;
+  uint64_t allocs = 0;
+  uint64_t bytes = 0;
+  uint64_t count = 0;
+  uint64_t errors = 0;
+};
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)(p * (v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  out = ss.str();
+  return true;
+}
+
+static void putFile(const char* path, const std::string& content) {
+  File f = LittleFS.open(path, "w");
+  f.write((const uint8_t*)content.data(), content.size());
+  f.close();
+}
+
+// Four full weeks at 5 min interval, written through Storage like on the device
+static void populate(Storage& storage, const std::string& dataDir) {
+  for (const char* name : {"index.html", "script.js", "style.css"}) {
+    std::string content;
+    if (!readFile(dataDir + "/" + name, content)) {
+      fprintf(stderr, "warning: %s/%s not found, serving placeholder\n", dataDir.c_str(), name);
+      content = std::string(4096, 'x');
+    }
+    putFile((std::string("/") + name).c_str(), content);
+  }
+  const uint32_t start = 1735689600; // 2025-01-01, day 0 of 2025-W01
+  Measurement batch[200];
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < 4 * 2016; i++) {
+    batch[n++] = {start + i * 300, 20.0f + 5.0f * sinf(i / 40.0f), 50.0f + 10.0f * cosf(i / 55.0f)};
+    if (n == 200) {
+      storage.saveBatch(batch, (uint8_t)n);
+      n = 0;
+    }
+  }
+  if (n) storage.saveBatch(batch, (uint8_t)n);
+}
+
+// Browser side of one connection
+struct SimConnection {
+  std::shared_ptr<HostConnection> conn = std::make_shared<HostConnection>();
+  double connectedAtMs;  // handshake done, the connection enters the accept backlog
+  bool accepted = false; // handed to the server's backlog
+  bool spare = false;    // preconnected socket that never carries a request
+  bool busy = false;     // request sent, response not received yet
+  double freeAtMs = 0;   // response arrived at the browser, next request reaches the server
+  Arrival request = {};
+  size_t received = 0;
+  bool open() const { return !conn->serverClosed && !conn->clientClosed; }
+};
+
+struct SimClient {
+  std::vector<Arrival> pending; // not sent yet, in arrival order
+  std::vector<SimConnection> conns;
+  int outstanding = 0;
+  int wave = 0;
+  bool loaded = false;          // page load started (spare sockets opened)
+};
+
+struct SimOptions {
+  double connMs, rttMs, loopMs;
+  int parallel, spare;
+};
+
+static int g_connections = 0;
+
+static HostRequest makeRequest(const Arrival& a) {
+  HostRequest req;
+  req.uri = ROUTES[a.route].uri;
+  if (ROUTES[a.route].acceptEncoding) req.headers.push_back({"Accept-Encoding", ROUTES[a.route].acceptEncoding});
+  return req;
+}
+
+// Like a browser: reuse an idle keep-alive connection, else open a new one (up to
+// --parallel per client). A request of the next wave waits for all responses. A reused
+// connection carries the next request one --rtt-ms after the response was sent
+static void sendDue(SimClient& c, double nowMs, const SimOptions& opt) {
+  while (!c.pending.empty() && c.pending.front().atMs <= nowMs) {
+    const Arrival& a = c.pending.front();
+    if (c.outstanding > 0 && a.wave != c.wave) break;
+    if (a.pageLoad && !c.loaded) {
+      c.loaded = true;
+      for (int i = 0; i < opt.spare; i++) {
+        SimConnection sc;
+        sc.connectedAtMs = nowMs + opt.connMs;
+        sc.spare = true;
+        c.conns.push_back(sc);
+        g_connections++;
+      }
+    }
+    SimConnection* use = nullptr;
+    int inUse = 0;
+    bool arriving = false; // a response is still on its way to the browser
+    for (SimConnection& sc : c.conns) {
+      if (sc.spare || !sc.open()) continue;
+      inUse++;
+      if (!sc.busy && sc.freeAtMs > nowMs) arriving = true;
+      else if (!sc.busy && !use) use = &sc;
+    }
+    if (!use) {
+      if (arriving) break;
+      if (inUse >= opt.parallel) break;
+      SimConnection sc;
+      sc.connectedAtMs = nowMs + opt.connMs;
+      // the new connection is handed to the server before the spare sockets
+      c.conns.insert(c.conns.begin(), sc);
+      use = &c.conns.front();
+      g_connections++;
+    }
+    use->conn->inbound.push_back(makeRequest(a));
+    use->busy = true;
+    use->request = a;
+    c.wave = a.wave;
+    c.outstanding++;
+    c.pending.erase(c.pending.begin());
+  }
+}
+
+int main(int argc, char** argv) {
+  double seconds = 600, linkKBps = 50;
+  SimOptions opt = {15, 5, 1, 6, 0};
+  std::string dataDir = "../../data", baselinePath, writeBaseline;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string a = argv[i];
+    if (a == "--seconds") seconds = atof(argv[i + 1]);
+    else if (a == "--link-kBps") linkKBps = atof(argv[i + 1]);
+    else if (a == "--conn-ms") opt.connMs = atof(argv[i + 1]);
+    else if (a == "--rtt-ms") opt.rttMs = atof(argv[i + 1]);
+    else if (a == "--loop-ms") opt.loopMs = std::max(0.01, atof(argv[i + 1]));
+    else if (a == "--parallel") opt.parallel = std::max(1, atoi(argv[i + 1]));
+    else if (a == "--spare") opt.spare = std::max(0, atoi(argv[i + 1]));
+    else if (a == "--data") dataDir = argv[i + 1];
+    else if (a == "--baseline") baselinePath = argv[i + 1];
+    else if (a == "--write-baseline") writeBaseline = argv[i + 1];
+    else { fprintf(stderr, "unknown option %s\n", a.c_str()); return 2; }
+  }
+
+  Storage storage;
+  storage.begin();
+  populate(storage, dataDir);
+  Summary summary;
+  for (uint32_t i = 0; i < 2016; i++)
+    summary.add({1737504000 + i * 300, 20.0f + 5.0f * sinf(i / 40.0f), 50.0f + 10.0f * cosf(i / 55.0f)});
+  WebserverHandler webserver;
+  webserver.begin(&storage, nullptr);
+  webserver.setSummary(&summary);
+  webserver.updateLastMeasurement({1737504000, 21.5f, 48.2f});
+  ESP8266WebServer& server = *ESP8266WebServer::lastInstance;
+
+  std::ostringstream baselineOut;
+  std::map<std::string, std::pair<double, double>> baseline; // key -> allocs, bytes
+  if (!baselinePath.empty()) {
+    std::ifstream f(baselinePath);
+    std::string line;
+    while (std::getline(f, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream ls(line);
+      std::string scen, route;
+      double allocs, bytes;
+      if (ls >> scen >> route >> allocs >> bytes) baseline[scen + "/" + route] = {allocs, bytes};
+    }
+    if (baseline.empty()) fprintf(stderr, "warning: no entries in baseline %s\n", baselinePath.c_str());
+  }
+  int regressions = 0;
+
+  printf("model: firmware handleClient() every %.1f ms + service time, transfer %.0f KB/s, %.0f ms TCP handshake,\n"
+         "       %.0f ms round trip, up to %d connections per client, %d spare socket(s) per page load\n\n",
+         opt.loopMs, linkKBps, opt.connMs, opt.rttMs, opt.parallel, opt.spare);
+  ESP8266WebServer::hostAllocCounter = []() -> uint64_t { return g_allocs; };
+  g_counting = true;
+  for (const Scenario& sc : SCENARIOS) {
+    std::mt19937 rng(42);
+    g_nextClient = 0;
+    std::vector<Arrival> arrivals = sc.generate(seconds, rng);
+    std::sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) { return a.atMs < b.atMs; });
+    std::vector<SimClient> clients(g_nextClient);
+    for (const Arrival& a : arrivals) clients[a.client].pending.push_back(a);
+
+    std::map<int, RouteStats> stats;
+    double nowMs = 0, busyMs = 0;
+    const double endMs = seconds * 1000.0, giveUpMs = endMs + 600000.0;
+    size_t served = 0;
+    g_connections = 0;
+    while (served < arrivals.size() && nowMs < giveUpMs) {
+      hostVirtualMillis = (int64_t)nowMs;
+      for (SimClient& c : clients) {
+        sendDue(c, nowMs, opt);
+        for (SimConnection& conn : c.conns) {
+          if (!conn.accepted && conn.connectedAtMs <= nowMs) {
+            server.getServer().hostConnect(conn.conn);
+            conn.accepted = true;
+          }
+          // browsers drop unused preconnected sockets after 10 s
+          if (conn.spare && conn.connectedAtMs + 10000.0 <= nowMs) conn.conn->clientClosed = true;
+        }
+      }
+
+      // one loop() pass; responses are on the wire when it returns
+      std::vector<std::pair<const HostResponse*, SimConnection*>> done;
+      webserver.handleClient();
+      double serviceMs = 0;
+      for (SimClient& c : clients) {
+        for (SimConnection& conn : c.conns) {
+          while (conn.received < conn.conn->served.size()) {
+            const HostResponse& resp = conn.conn->served[conn.received++];
+            serviceMs += resp.cpuUs / 1000.0 + resp.raw.size() / (linkKBps * 1024.0) * 1000.0;
+            done.push_back({&resp, &conn});
+          }
+        }
+      }
+      busyMs += serviceMs;
+      nowMs += opt.loopMs + serviceMs;
+
+      for (auto& d : done) {
+        const HostResponse& resp = *d.first;
+        SimConnection& conn = *d.second;
+        RouteStats& rs = stats[conn.request.route];
+        rs.count++;
+        rs.cpuUs.push_back(resp.cpuUs);
+        rs.latencyMs.push_back(nowMs - conn.request.atMs);
+        rs.allocs += resp.allocs;
+        rs.bytes += resp.raw.size();
+        if (resp.status != 200) rs.errors++;
+        conn.busy = false;
+        conn.freeAtMs = nowMs + opt.rttMs;
+        clients[conn.request.client].outstanding--;
+        served++;
+      }
+      for (SimClient& c : clients) {
+        for (size_t i = 0; i < c.conns.size();) {
+          SimConnection& conn = c.conns[i];
+          if (conn.open()) {
+            i++;
+            continue;
+          }
+          if (conn.busy) {
+            // closed before the request was read: the browser sends it again
+            c.pending.insert(c.pending.begin(), conn.request);
+            c.outstanding--;
+          }
+          c.conns.erase(c.conns.begin() + i);
+        }
+      }
+    }
+    hostVirtualMillis = -1;
+    if (served < arrivals.size()) {
+      printf("== %s: only %zu of %zu requests served\n", sc.name, served, arrivals.size());
+      regressions++;
+    }
+
+    printf("== %s: %s (%zu requests on %d connections in %.0f s, server busy %.1f%%)\n", sc.name, sc.description,
+           arrivals.size(), g_connections, seconds, 100.0 * busyMs / (seconds * 1000.0));
+    printf("%-14s %6s %10s %10s %10s %12s %10s %10s %8s\n", "route", "count", "cpu p50us", "cpu p99us", "host rps",
+           "allocs/req", "bytes/req", "lat p50ms", "lat p99ms");
+    for (auto& kv : stats) {
+      RouteStats& rs = kv.second;
+      double meanCpu = 0;
+      for (double c : rs.cpuUs) meanCpu += c;
+      meanCpu /= rs.count;
+      double allocsPerReq = (double)rs.allocs / rs.count;
+      double bytesPerReq = (double)rs.bytes / rs.count;
+      printf("%-14s %6llu %10.1f %10.1f %10.0f %12.1f %10.0f %10.1f %10.1f%s\n", ROUTES[kv.first].name,
+             (unsigned long long)rs.count, percentile(rs.cpuUs, 0.5), percentile(rs.cpuUs, 0.99),
+             meanCpu > 0 ? 1e6 / meanCpu : 0, allocsPerReq, bytesPerReq, percentile(rs.latencyMs, 0.5),
+             percentile(rs.latencyMs, 0.99), rs.errors ? "  ERRORS" : "");
+      baselineOut << sc.name << " " << ROUTES[kv.first].name << " " << allocsPerReq << " " << bytesPerReq << "\n";
+
+      // Only the machine independent numbers are compared against the baseline
+      auto b = baseline.find(std::string(sc.name) + "/" + ROUTES[kv.first].name);
+      if (b != baseline.end()) {
+        if (allocsPerReq > b->second.first * 1.10 + 1) {
+          printf("  REGRESSION: allocs/req %.1f > baseline %.1f\n", allocsPerReq, b->second.first);
+          regressions++;
+        }
+        if (bytesPerReq > b->second.second * 1.10 + 16) {
+          printf("  REGRESSION: bytes/req %.0f > baseline %.0f\n", bytesPerReq, b->second.second);
+          regressions++;
+        }
+      }
+      if (rs.errors) regressions++;
+    }
+    printf("\n");
+  }
+
+  if (!writeBaseline.empty()) {
+    std::ofstream f(writeBaseline);
+    f << "# scenario route allocs_per_request bytes_per_request (written by loadtest --write-baseline)\n"
+      << baselineOut.str();
+    printf("baseline written to %s\n", writeBaseline.c_str());
+  }
+  if (regressions) printf("%d regression(s)\n", regressions);
+  return regressions ? 1 : 0;
+}
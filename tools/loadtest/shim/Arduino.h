@@ -0,0 +1,169 @@
+// tools/loadtest/shim/Arduino.h
+// Host stand-in for the parts of the Arduino/ESP8266 core the firmware modules use.
+#pragma once
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#define F(x) (x)
+#define LED_BUILTIN 2
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+
+class String {
+public:
+  String() {}
+  String(const char* s) : s(s ? s : "") {}
+  String(const std::string& str) : s(str) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned int v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(float v, unsigned char decimals = 2) { format(v, decimals); }
+  String(double v, unsigned char decimals = 2) { format(v, decimals); }
+
+  const char* c_str() const { return s.c_str(); }
+  unsigned int length() const { return (unsigned int)s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  bool reserve(unsigned int n) { s.reserve(n); return true; }
+
+  bool concat(const char* str) { if (str) s += str; return true; }
+  bool concat(const char* str, unsigned int n) { s.append(str, n); return true; }
+  bool concat(const String& str) { s += str.s; return true; }
+  bool concat(char c) { s += c; return true; }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { if (o) s += o; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(int v) { s += std::to_string(v); return *this; }
+  String& operator+=(unsigned int v) { s += std::to_string(v); return *this; }
+  String& operator+=(long v) { s += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { s += std::to_string(v); return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+  friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s); }
+  friend String operator+(const String& a, char b) { return String(a.s + b); }
+
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == (o ? o : ""); }
+  bool operator!=(const String& o) const { return s != o.s; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return s < o.s; }
+  bool operator>(const String& o) const { return s > o.s; }
+  char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char& operator[](unsigned int i) { return s[i]; }
+
+  bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+  bool endsWith(const String& p) const {
+    return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const { size_t p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+  int indexOf(const String& str, unsigned int from = 0) const { size_t p = s.find(str.s, from); return p == std::string::npos ? -1 : (int)p; }
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const { return from < to && from < s.size() ? String(s.substr(from, to - from)) : String(); }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return (float)atof(s.c_str()); }
+  void replace(const String& from, const String& to) {
+    if (from.s.empty()) return;
+    for (size_t p = 0; (p = s.find(from.s, p)) != std::string::npos; p += to.s.size()) s.replace(p, from.s.size(), to.s);
+  }
+  void trim() {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    s = b == std::string::npos ? "" : s.substr(b, e - b + 1);
+  }
+  void toLowerCase() { for (auto& c : s) c = (char)tolower((unsigned char)c); }
+  bool equalsIgnoreCase(const String& o) const {
+    return s.size() == o.s.size() && strncasecmp(s.c_str(), o.s.c_str(), s.size()) == 0;
+  }
+  void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+
+  const std::string& str() const { return s; }
+
+private:
+  std::string s;
+  void format(double v, unsigned char decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*buf++);
+    return n;
+  }
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t print(const char* str) { return write(str); }
+  size_t print(const String& str) { return write((const uint8_t*)str.c_str(), str.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned int v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t println() { return write((uint8_t)'\n'); }
+  template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    return write((const uint8_t*)buf, std::min((size_t)n, sizeof(buf) - 1));
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t readBytes(char* buf, size_t len) {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = read()) >= 0) buf[n++] = (char)c;
+    return n;
+  }
+  size_t readBytes(uint8_t* buf, size_t len) { return readBytes((char*)buf, len); }
+};
+
+// Serial output is discarded unless LOADTEST_VERBOSE is set in the environment
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t len) override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+// Host only: virtual clock behind millis(); < 0 means real time since start
+extern int64_t hostVirtualMillis;
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
@@ -0,0 +1,144 @@
+// tools/loadtest/shim/ESP8266WebServer.h
+// In-process stand-in for ESP8266WebServer: routes are registered exactly like on the
+// device. Requests are injected with dispatch(), or queued on a HostConnection and read by
+// handleClient() like the core does; the raw response is captured.
+#pragma once
+#include <functional>
+#include <map>
+#include <vector>
+#include "ESP8266WiFi.h"
+#include "FS.h"
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN 2048
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+#define HTTP_MAX_DATA_WAIT 5000  // ms a new connection may stay silent (core default)
+#define HTTP_MAX_DATA_AVAILABLE_WAIT 30 // the same while another client waits in the backlog
+#define HTTP_MAX_CLOSE_WAIT 2000 // ms an idle keep-alive connection stays open (core default)
+
+struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  String type;
+  size_t totalSize;
+  size_t currentSize;
+  size_t contentLength;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+// Host only: request to inject and the captured response
+struct HostRequest {
+  HTTPMethod method = HTTP_GET;
+  std::string uri;                                        // path with optional ?query
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;                                       // "plain" arg, or upload content
+  bool upload = false;                                    // deliver body through the upload callback
+};
+
+struct HostResponse {
+  int status = 0;
+  std::string raw;     // status line + headers + body, as sent on the wire
+  size_t bodyBytes = 0;
+  double cpuUs = 0;    // host time spent in dispatch
+  uint64_t allocs = 0; // heap allocations in dispatch (see hostAllocCounter)
+};
+
+// Host only: one TCP connection between the harness (as browser) and the server
+struct HostConnection {
+  std::deque<HostRequest> inbound;  // sent by the client, not read by the server yet
+  std::vector<HostResponse> served; // responses written to this connection, in order
+  bool serverClosed = false;        // stopped or dropped by the server
+  bool clientClosed = false;
+};
+
+class ESP8266WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit ESP8266WebServer(int port = 80) { (void)port; lastInstance = this; }
+  void begin() {}
+  // Serves the connection at the head of the accept backlog, one request per call,
+  // with the state machine and timeouts of the ESP8266 core 3.x
+  void handleClient();
+
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn) { on(uri, method, fn, nullptr); }
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn) {
+    routes.push_back({uri.str(), method, fn, ufn});
+  }
+  void onNotFound(THandlerFunction fn) { notFound = fn; }
+  void collectHeaders(const char* headerKeys[], size_t count);
+
+  String uri() { return String(curUri); }
+  HTTPMethod method() { return curMethod; }
+  String arg(const String& name);
+  bool hasArg(const String& name) { return args.count(name.str()) > 0; }
+  String header(const String& name);
+  String header(int i) { return String(reqHeaders[i].second); }
+  String headerName(int i) { return String(reqHeaders[i].first); }
+  int headers() { return (int)reqHeaders.size(); }
+  bool hasHeader(const String& name);
+
+  void send(int code, const char* contentType = nullptr, const String& content = String(""));
+  void send(int code, const char* contentType, const char* content, size_t len);
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t len) { contentLength = len; }
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t len);
+
+  template <typename T>
+  size_t streamFile(T& file, const String& contentType, HTTPMethod requestMethod = HTTP_GET) {
+    (void)requestMethod;
+    setContentLength(file.size());
+    send(200, contentType.c_str(), String(""));
+    uint8_t buf[1460];
+    size_t total = 0, n;
+    while ((n = file.read(buf, sizeof(buf))) > 0) total += currentClient.write(buf, n);
+    return total;
+  }
+
+  WiFiClient& client() { return currentClient; }
+  WiFiServer& getServer() { return listener; }
+  HTTPUpload& upload() { return *currentUpload; }
+
+  // Host only: run one request through the registered routes
+  HostResponse dispatch(const HostRequest& req) { return run(req, nullptr); }
+  // Host only: returns the number of heap allocations so far (set by the harness)
+  static uint64_t (*hostAllocCounter)();
+  // Host only: the most recently constructed server (WebserverHandler keeps its own private)
+  static ESP8266WebServer* lastInstance;
+
+private:
+  struct Route {
+    std::string uri;
+    HTTPMethod method;
+    THandlerFunction fn;
+    THandlerFunction ufn;
+  };
+  enum ClientStatus { HC_NONE, HC_WAIT_READ, HC_WAIT_CLOSE };
+
+  std::vector<Route> routes;
+  WiFiServer listener;
+  ClientStatus hcStatus = HC_NONE;
+  unsigned long statusChange = 0;
+  bool keepAlive = false;
+  THandlerFunction notFound;
+  std::vector<std::string> collected = {"Authorization"};
+
+  std::string curUri;
+  HTTPMethod curMethod = HTTP_GET;
+  std::map<std::string, std::string> args;
+  std::vector<std::pair<std::string, std::string>> reqHeaders;
+  std::vector<std::pair<std::string, std::string>> respHeaders;
+  size_t contentLength = CONTENT_LENGTH_NOT_SET;
+  bool chunked = false;
+  std::string out;
+  HostResponse* resp = nullptr;
+  WiFiClient currentClient;
+  std::unique_ptr<HTTPUpload> currentUpload;
+
+  HostResponse run(const HostRequest& req, std::shared_ptr<HostConnection> conn);
+};
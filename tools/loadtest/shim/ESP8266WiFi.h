@@ -0,0 +1,53 @@
+// tools/loadtest/shim/ESP8266WiFi.h
+#pragma once
+#include <deque>
+#include "Arduino.h"
+
+struct HostConnection; // ESP8266WebServer.h
+
+// Connection to the HTTP client; everything written goes into the current response.
+// With a HostConnection the harness plays the browser: available() is the next queued
+// request, stop() closes the socket from the server side
+class WiFiClient : public Stream {
+public:
+  explicit WiFiClient(std::string* sink = nullptr, std::shared_ptr<HostConnection> conn = nullptr)
+    : sink(sink), conn(conn) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override;
+  int available() override;
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  bool connected();
+  void stop();
+  explicit operator bool() { return sink != nullptr || conn != nullptr; }
+
+  // Host only
+  std::shared_ptr<HostConnection> connection() const { return conn; }
+
+private:
+  std::string* sink;
+  std::shared_ptr<HostConnection> conn;
+};
+
+// Listening socket: connections the harness opened wait in the accept backlog
+class WiFiServer {
+public:
+  explicit WiFiServer(uint16_t port = 80) { (void)port; }
+  bool hasClient() { return !backlog.empty(); }
+  WiFiClient accept();
+
+  // Host only: a client finished the TCP handshake
+  void hostConnect(std::shared_ptr<HostConnection> conn) { backlog.push_back(conn); }
+
+private:
+  std::deque<std::shared_ptr<HostConnection>> backlog;
+};
+
+enum wl_status_t { WL_IDLE_STATUS, WL_CONNECTED, WL_DISCONNECTED };
+
+// Station interface; the host is always "connected"
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+};
+extern WiFiClass WiFi;
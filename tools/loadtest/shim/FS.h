@@ -0,0 +1,92 @@
+// tools/loadtest/shim/FS.h
+// In-memory stand-in for the ESP8266 FS API (File, Dir, FSInfo).
+#pragma once
+#include <map>
+#include <vector>
+#include "Arduino.h"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FsNode {
+  std::vector<uint8_t> data;
+  time_t lastWrite = 0;
+  time_t creation = 0;
+};
+
+class File : public Stream {
+public:
+  File() {}
+  File(std::shared_ptr<FsNode> node, const String& name, bool append) : node(node), fname(name) {
+    if (append) pos = node->data.size();
+  }
+  explicit operator bool() const { return (bool)node; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override;
+  int available() override { return node ? (int)(node->data.size() - pos) : 0; }
+  int read() override { return node && pos < node->data.size() ? node->data[pos++] : -1; }
+  int peek() override { return node && pos < node->data.size() ? node->data[pos] : -1; }
+  size_t read(uint8_t* buf, size_t len);
+  size_t readBytes(char* buf, size_t len) override { return read((uint8_t*)buf, len); }
+  bool seek(uint32_t p, SeekMode mode = SeekSet);
+  size_t position() const { return pos; }
+  size_t size() const { return node ? node->data.size() : 0; }
+  bool truncate(uint32_t size);
+  void close() { node.reset(); }
+  const char* name() const { return fname.c_str(); }
+  time_t getLastWrite() { return node ? node->lastWrite : 0; }
+  time_t getCreationTime() { return node ? node->creation : 0; }
+
+private:
+  std::shared_ptr<FsNode> node;
+  String fname;
+  size_t pos = 0;
+};
+
+struct FSInfo {
+  size_t totalBytes;
+  size_t usedBytes;
+  size_t blockSize;
+  size_t pageSize;
+  size_t maxOpenFiles;
+  size_t maxPathLength;
+};
+
+class Dir {
+public:
+  Dir() {}
+  explicit Dir(std::vector<std::pair<String, size_t>> entries) : entries(std::move(entries)) {}
+  bool next() { return ++index < (int)entries.size(); }
+  String fileName() { return entries[index].first; }
+  size_t fileSize() { return entries[index].second; }
+  bool isFile() const { return true; }
+
+private:
+  std::vector<std::pair<String, size_t>> entries;
+  int index = -1;
+};
+
+class FS {
+public:
+  bool begin() { return true; }
+  bool exists(const char* path) { return files.count(path) > 0; }
+  bool exists(const String& path) { return exists(path.c_str()); }
+  File open(const char* path, const char* mode);
+  File open(const String& path, const char* mode) { return open(path.c_str(), mode); }
+  Dir openDir(const char* path);
+  bool remove(const char* path) { return files.erase(path) > 0; }
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char*) { return true; }
+  bool info(FSInfo& info);
+
+  // Host only: flash size reported by info()
+  size_t totalBytes = 2 * 1024 * 1024;
+  // Host only: this many more opens for writing succeed, then all fail (flash full,
+  // worn out); < 0 = never fail
+  int writeOpensLeft = -1;
+
+private:
+  std::map<std::string, std::shared_ptr<FsNode>> files;
+};
@@ -0,0 +1,5 @@
+// tools/loadtest/shim/LittleFS.h
+#pragma once
+#include "FS.h"
+
+extern FS LittleFS;
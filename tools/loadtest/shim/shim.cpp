@@ -0,0 +1,372 @@
+// tools/loadtest/shim/shim.cpp
+#include <chrono>
+#include <strings.h>
+#include "Arduino.h"
+#include "ESP8266WebServer.h"
+#include "LittleFS.h"
+#include "ESP8266WiFi.h"
+
+HardwareSerial Serial;
+FS LittleFS;
+WiFiClass WiFi;
+ESP8266WebServer* ESP8266WebServer::lastInstance = nullptr;
+uint64_t (*ESP8266WebServer::hostAllocCounter)() = nullptr;
+int64_t hostVirtualMillis = -1;
+
+static bool serialVerbose() {
+  static const bool verbose = getenv("LOADTEST_VERBOSE") != nullptr;
+  return verbose;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (serialVerbose()) fputc(c, stderr);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+  if (serialVerbose()) fwrite(buf, 1, len, stderr);
+  return len;
+}
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  if (hostVirtualMillis >= 0) return (unsigned long)hostVirtualMillis;
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long) {}
+void yield() {}
+
+// ---- File / FS ----
+
+size_t File::write(const uint8_t* buf, size_t len) {
+  if (!node) return 0;
+  if (pos + len > node->data.size()) node->data.resize(pos + len);
+  memcpy(node->data.data() + pos, buf, len);
+  pos += len;
+  node->lastWrite = time(nullptr);
+  return len;
+}
+
+size_t File::read(uint8_t* buf, size_t len) {
+  if (!node || pos >= node->data.size()) return 0;
+  size_t n = std::min(len, node->data.size() - pos);
+  memcpy(buf, node->data.data() + pos, n);
+  pos += n;
+  return n;
+}
+
+bool File::seek(uint32_t p, SeekMode mode) {
+  if (!node) return false;
+  size_t target = mode == SeekSet ? p : mode == SeekCur ? pos + p : node->data.size() + p;
+  if (target > node->data.size()) return false;
+  pos = target;
+  return true;
+}
+
+bool File::truncate(uint32_t size) {
+  if (!node) return false;
+  node->data.resize(size);
+  if (pos > size) pos = size;
+  return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+  auto it = files.find(path);
+  bool write = mode[0] == 'w' || mode[0] == 'a';
+  if (write && writeOpensLeft == 0) return File();
+  if (write && writeOpensLeft > 0) writeOpensLeft--;
+  if (it == files.end()) {
+    if (!write) return File();
+    it = files.emplace(path, std::make_shared<FsNode>()).first;
+    it->second->creation = time(nullptr);
+  }
+  if (mode[0] == 'w') it->second->data.clear();
+  const char* slash = strrchr(path, '/');
+  return File(it->second, String(slash ? slash + 1 : path), mode[0] == 'a');
+}
+
+Dir FS::openDir(const char* path) {
+  std::string prefix = path;
+  if (prefix.empty() || prefix.back() != '/') prefix += '/';
+  std::vector<std::pair<String, size_t>> entries;
+  for (auto& f : files) {
+    if (f.first.compare(0, prefix.size(), prefix) != 0) continue;
+    std::string rest = f.first.substr(prefix.size());
+    if (rest.find('/') != std::string::npos) continue; // subdirectory
+    entries.push_back({String(rest), f.second->data.size()});
+  }
+  return Dir(std::move(entries));
+}
+
+bool FS::rename(const char* from, const char* to) {
+  auto it = files.find(from);
+  if (it == files.end()) return false;
+  files[to] = it->second;
+  files.erase(from);
+  return true;
+}
+
+bool FS::info(FSInfo& info) {
+  const size_t block = 8192; // LittleFS block size on the ESP8266
+  size_t used = 2 * block;   // superblock pair
+  for (auto& f : files) used += ((f.second->data.size() + block - 1) / block + 1) * block;
+  info = FSInfo{totalBytes, std::min(used, totalBytes), block, 256, 5, 32};
+  return true;
+}
+
+// ---- WiFiClient / WiFiServer ----
+
+size_t WiFiClient::write(const uint8_t* buf, size_t len) {
+  if (conn && (conn->serverClosed || conn->clientClosed)) return 0;
+  if (sink) sink->append((const char*)buf, len);
+  return len;
+}
+
+int WiFiClient::available() {
+  if (!conn || conn->serverClosed || conn->inbound.empty()) return 0;
+  const HostRequest& req = conn->inbound.front();
+  return (int)(req.uri.size() + req.body.size() + 16);
+}
+
+bool WiFiClient::connected() {
+  if (conn) return !conn->serverClosed && !conn->clientClosed;
+  return sink != nullptr;
+}
+
+void WiFiClient::stop() {
+  if (conn) conn->serverClosed = true;
+}
+
+WiFiClient WiFiServer::accept() {
+  if (backlog.empty()) return WiFiClient();
+  std::shared_ptr<HostConnection> conn = backlog.front();
+  backlog.pop_front();
+  return WiFiClient(nullptr, conn);
+}
+
+// ---- ESP8266WebServer ----
+
+static std::string urlDecode(const std::string& s) {
+  std::string out;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '+') out += ' ';
+    else if (s[i] == '%' && i + 2 < s.size()) {
+      out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+      i += 2;
+    } else out += s[i];
+  }
+  return out;
+}
+
+static const char* reasonPhrase(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 416: return "Range Not Satisfiable";
+    case 500: return "Internal Server Error";
+    default: return "";
+  }
+}
+
+void ESP8266WebServer::collectHeaders(const char* headerKeys[], size_t count) {
+  collected = {"Authorization"};
+  for (size_t i = 0; i < count; i++) collected.push_back(headerKeys[i]);
+}
+
+String ESP8266WebServer::arg(const String& name) {
+  auto it = args.find(name.str());
+  return it == args.end() ? String() : String(it->second);
+}
+
+String ESP8266WebServer::header(const String& name) {
+  for (auto& h : reqHeaders)
+    if (strcasecmp(h.first.c_str(), name.c_str()) == 0) return String(h.second);
+  return String();
+}
+
+bool ESP8266WebServer::hasHeader(const String& name) {
+  for (auto& h : reqHeaders)
+    if (strcasecmp(h.first.c_str(), name.c_str()) == 0) return true;
+  return false;
+}
+
+void ESP8266WebServer::sendHeader(const String& name, const String& value, bool first) {
+  if (first) respHeaders.insert(respHeaders.begin(), {name.str(), value.str()});
+  else respHeaders.push_back({name.str(), value.str()});
+}
+
+void ESP8266WebServer::send(int code, const char* contentType, const String& content) {
+  send(code, contentType, content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send(int code, const char* contentType, const char* content, size_t len) {
+  resp->status = code;
+  std::string head = "HTTP/1.1 " + std::to_string(code) + " " + reasonPhrase(code) + "\r\n";
+  head += std::string("Content-Type: ") + (contentType ? contentType : "text/html") + "\r\n";
+  if (contentLength == CONTENT_LENGTH_UNKNOWN) {
+    chunked = true;
+    head += "Transfer-Encoding: chunked\r\n";
+  } else {
+    head += "Content-Length: " + std::to_string(contentLength == CONTENT_LENGTH_NOT_SET ? len : contentLength) + "\r\n";
+  }
+  for (auto& h : respHeaders) head += h.first + ": " + h.second + "\r\n";
+  // HTTP/1.1 client and a framed response: the core keeps the connection open
+  if (keepAlive) head += "Connection: keep-alive\r\nKeep-Alive: timeout=" + std::to_string(HTTP_MAX_CLOSE_WAIT) + "\r\n\r\n";
+  else head += "Connection: close\r\n\r\n";
+  out += head;
+  if (len) sendContent(content, len);
+  respHeaders.clear();
+}
+
+void ESP8266WebServer::sendContent(const char* content, size_t len) {
+  if (chunked && len == 0) {
+    // empty chunk ends the response, like the core
+    out += "0\r\n\r\n";
+    chunked = false;
+  } else if (chunked) {
+    char size[24]; // up to 16 hex digits + CRLF
+    snprintf(size, sizeof(size), "%zx\r\n", len);
+    out += size;
+    out.append(content, len);
+    out += "\r\n";
+  } else {
+    out.append(content, len);
+  }
+}
+
+// Same states and timeouts as ESP8266WebServerTemplate::handleClient() in core 3.x
+void ESP8266WebServer::handleClient() {
+  if (hcStatus == HC_NONE) {
+    if (!listener.hasClient()) return;
+    currentClient = listener.accept();
+    hcStatus = HC_WAIT_READ;
+    statusChange = millis();
+  }
+
+  bool keepCurrentClient = false;
+  if (currentClient.connected() || currentClient.available()) {
+    if (currentClient.available() && keepAlive) hcStatus = HC_WAIT_READ;
+    switch (hcStatus) {
+      case HC_NONE:
+        break;
+      case HC_WAIT_READ:
+        if (currentClient.available()) {
+          std::shared_ptr<HostConnection> conn = currentClient.connection();
+          HostRequest req = conn->inbound.front();
+          conn->inbound.pop_front();
+          conn->served.push_back(run(req, conn));
+          if (currentClient.connected() || currentClient.available()) {
+            hcStatus = HC_WAIT_CLOSE;
+            statusChange = millis();
+            keepCurrentClient = true;
+          }
+        } else if (millis() - statusChange <= (listener.hasClient() ? HTTP_MAX_DATA_AVAILABLE_WAIT : HTTP_MAX_DATA_WAIT)) {
+          // a silent connection gives way to a waiting client after a short grace time
+          keepCurrentClient = true;
+        }
+        break;
+      case HC_WAIT_CLOSE:
+        // an idle keep-alive connection gives way to a waiting client
+        if (!listener.hasClient() && millis() - statusChange <= HTTP_MAX_CLOSE_WAIT) keepCurrentClient = true;
+        break;
+    }
+  }
+
+  if (!keepCurrentClient) {
+    currentClient.stop();
+    currentClient = WiFiClient();
+    hcStatus = HC_NONE;
+  }
+}
+
+HostResponse ESP8266WebServer::run(const HostRequest& req, std::shared_ptr<HostConnection> conn) {
+  uint64_t allocs0 = hostAllocCounter ? hostAllocCounter() : 0;
+  auto t0 = std::chrono::steady_clock::now();
+  HostResponse r;
+  resp = &r;
+  out.clear();
+  respHeaders.clear();
+  contentLength = CONTENT_LENGTH_NOT_SET;
+  chunked = false;
+  currentClient = WiFiClient(&out, conn);
+
+  size_t q = req.uri.find('?');
+  curUri = req.uri.substr(0, q);
+  curMethod = req.method;
+  args.clear();
+  if (q != std::string::npos) {
+    std::string query = req.uri.substr(q + 1);
+    size_t pos = 0;
+    while (pos <= query.size()) {
+      size_t amp = query.find('&', pos);
+      if (amp == std::string::npos) amp = query.size();
+      std::string kv = query.substr(pos, amp - pos);
+      size_t eq = kv.find('=');
+      if (!kv.empty()) args[urlDecode(kv.substr(0, eq))] = eq == std::string::npos ? "" : urlDecode(kv.substr(eq + 1));
+      pos = amp + 1;
+    }
+  }
+  if (!req.body.empty() && !req.upload) args["plain"] = req.body;
+
+  // HTTP/1.1: keep-alive unless the client asks to close
+  keepAlive = true;
+  for (auto& h : req.headers)
+    if (strcasecmp(h.first.c_str(), "Connection") == 0 && strcasecmp(h.second.c_str(), "close") == 0) keepAlive = false;
+
+  // Only collected headers are visible to handlers, like on the device
+  reqHeaders.clear();
+  for (auto& name : collected)
+    for (auto& h : req.headers)
+      if (strcasecmp(h.first.c_str(), name.c_str()) == 0) reqHeaders.push_back(h);
+
+  const Route* route = nullptr;
+  for (auto& rt : routes)
+    if (rt.uri == curUri && (rt.method == HTTP_ANY || rt.method == curMethod)) { route = &rt; break; }
+
+  if (route && req.upload && route->ufn) {
+    currentUpload.reset(new HTTPUpload());
+    HTTPUpload& up = *currentUpload;
+    up.filename = "upload";
+    up.name = "file";
+    up.totalSize = 0;
+    up.status = UPLOAD_FILE_START;
+    up.currentSize = 0;
+    route->ufn();
+    for (size_t off = 0; off < req.body.size(); off += HTTP_UPLOAD_BUFLEN) {
+      up.status = UPLOAD_FILE_WRITE;
+      up.currentSize = std::min((size_t)HTTP_UPLOAD_BUFLEN, req.body.size() - off);
+      memcpy(up.buf, req.body.data() + off, up.currentSize);
+      up.totalSize += up.currentSize;
+      route->ufn();
+    }
+    up.status = UPLOAD_FILE_END;
+    up.currentSize = 0;
+    route->ufn();
+  }
+
+  if (route) route->fn();
+  else if (notFound) notFound();
+  else send(404, "text/plain", String("Not found"));
+
+  if (chunked) out += "0\r\n\r\n";
+  r.raw.swap(out);
+  size_t hdrEnd = r.raw.find("\r\n\r\n");
+  r.bodyBytes = hdrEnd == std::string::npos ? 0 : r.raw.size() - hdrEnd - 4;
+  resp = nullptr;
+  currentClient = WiFiClient(nullptr, conn);
+  currentUpload.reset();
+  r.cpuUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  r.allocs = hostAllocCounter ? hostAllocCounter() - allocs0 : 0;
+  return r;
+}